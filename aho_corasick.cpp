@@ -0,0 +1,130 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+#include "aho_corasick.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+
+void AhoCorasick::build(const std::vector<std::string>& patterns)
+{
+    // Plain trie first, the children of a node sorted by byte
+    struct trie_node
+    {
+        std::vector<std::pair<unsigned char, size_t>> children;
+        std::vector<size_t> ids;
+    };
+    std::vector<trie_node> trie(1);
+
+    lengths_.reserve(patterns.size());
+    for(size_t id = 0; id < patterns.size(); ++id)
+    {
+        lengths_.push_back(patterns[id].size());
+        if(patterns[id].empty())
+            continue;
+
+        size_t u = 0;
+        for(const char ch : patterns[id])
+        {
+            const auto c = static_cast<unsigned char>(ch);
+            auto& children = trie[u].children;
+            const auto pos = std::lower_bound(children.begin(), children.end(), std::make_pair(c, size_t(0)));
+            if(pos != children.end() && pos->first == c)
+                u = pos->second;
+            else
+            {
+                u = trie.size();
+                children.insert(pos, {c, u});
+                trie.emplace_back();
+            }
+        }
+        trie[u].ids.push_back(id);
+    }
+    states_ = trie.size();
+
+    // The nodes are placed in breadth-first order, each set of children at the lowest base where all of its
+    // entries are free. The bases are tried at the free slots only, skip leading from a slot to the next free one
+    // (union-find, path halving), since the array is mostly full
+    std::vector<size_t> order{0}, position(trie.size()), skip;
+    nodes_.clear();
+    const auto grow = [&](size_t size) {
+        for(size_t i = nodes_.size(); i < size; ++i)
+            skip.push_back(i);
+        nodes_.resize(size);
+    };
+    const auto find_free = [&](size_t i) {
+        while(skip[i] != i)
+            i = skip[i] = skip[skip[i]];
+        return i;
+    };
+    grow(257);
+    skip[0] = 1;
+
+    for(size_t k = 0; k < order.size(); ++k)
+    {
+        const auto& children = trie[order[k]].children;
+        if(children.empty())
+            continue;
+
+        const size_t first = children[0].first;
+        size_t base = 0;
+        for(size_t f = find_free(first);; f = find_free(f + 1))
+        {
+            base = f - first;
+            if(base + 257 > nodes_.size())
+                grow(std::max(base + 257, 2 * nodes_.size()));
+            if(std::all_of(children.begin() + 1, children.end(), [&](const auto& c) {
+                   return nodes_[base + c.first].check == -1;
+               }))
+                break;
+        }
+        if(base + 256 > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+            throw std::length_error("");
+
+        const size_t p = position[order[k]];
+        nodes_[p].base = static_cast<int32_t>(base);
+        for(const auto& [c, v] : children)
+        {
+            nodes_[base + c].check = static_cast<int32_t>(p);
+            skip[base + c] = base + c + 1;
+            position[v] = base + c;
+            order.push_back(v);
+        }
+    }
+
+    // Only the entries that a base can reach are kept
+    size_t size = 0;
+    for(size_t p = 0; p < nodes_.size(); ++p)
+        if(nodes_[p].check != -1 || p == 0)
+            size = std::max(size, static_cast<size_t>(nodes_[p].base) + 256);
+    nodes_.resize(size);
+    nodes_.shrink_to_fit();
+
+    // Fail links in breadth-first order, those of the shallower states being known
+    for(size_t k = 1; k < order.size(); ++k)
+    {
+        const size_t p = position[order[k]];
+        const int32_t parent = nodes_[p].check;
+        const auto c = static_cast<unsigned char>(p - nodes_[parent].base);
+        nodes_[p].fail = parent == 0 ? 0 : next(nodes_[parent].fail, c);
+    }
+
+    // Outputs, grouped by position
+    outputs_.assign(nodes_.size() + 1, 0);
+    for(size_t u = 0; u < trie.size(); ++u)
+        outputs_[position[u] + 1] = trie[u].ids.size();
+    for(size_t p = 0; p < nodes_.size(); ++p)
+        outputs_[p + 1] += outputs_[p];
+    ids_.resize(outputs_.back());
+    for(size_t u = 0; u < trie.size(); ++u)
+        std::copy(trie[u].ids.begin(), trie[u].ids.end(), ids_.begin() + outputs_[position[u]]);
+
+    for(size_t k = 1; k < order.size(); ++k)
+    {
+        const size_t p = position[order[k]];
+        nodes_[p].report = outputs_[p] != outputs_[p + 1] ? static_cast<int32_t>(p) : nodes_[nodes_[p].fail].report;
+    }
+}
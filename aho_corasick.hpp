@@ -0,0 +1,123 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+#ifndef UTILITIES_AHO_CORASICK_HPP
+#define UTILITIES_AHO_CORASICK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// Searches many byte patterns at once in a single pass over a text, with the Aho-Corasick automaton. The trie is
+// stored as a double array: the child of state s by byte c is base[s] + c when check of that state is s, so a
+// transition is one lookup, and the fields of a state are interleaved so that it sits in a single cache line
+class AhoCorasick
+{
+    public:
+        struct match
+        {
+            size_t pattern;
+            size_t offset;
+        };
+
+        // One pattern per element of [first, last), each a sequence of bytes (std::string, std::string_view,
+        // std::vector<char>...). The patterns are numbered from 0 in that order, the empty ones never match
+        template<typename Iter>
+        AhoCorasick(Iter first, Iter last);
+
+        // Calls f(pattern, offset) for every occurrence of every pattern in a sequence of bytes, in the order of
+        // their last element, the longest first for a same end. A single pass, so any input iterator will do
+        template<typename Iter2, typename F>
+        void for_each_match(Iter2 first, Iter2 last, F&& f) const;
+
+        // Every occurrence of every pattern, in the order of for_each_match
+        template<typename Iter2>
+        std::vector<match> find_all(Iter2 first, Iter2 last) const;
+
+        // getters
+        size_t pattern_count() const noexcept { return lengths_.size(); }
+        size_t state_count() const noexcept { return states_; }
+
+    private:
+        struct node
+        {
+            // Children at base + c, check being the parent of a used entry and -1 for a free one
+            int32_t base = 0;
+            int32_t check = -1;
+            // Longest proper suffix of the state that is also a state
+            int32_t fail = 0;
+            // First state on the fail chain, this one included, at the end of a pattern, -1 if there is none
+            int32_t report = -1;
+        };
+
+        void build(const std::vector<std::string>& patterns);
+
+        // Transition from s by c, the fail links being followed until the root
+        int32_t next(int32_t s, unsigned char c) const noexcept;
+
+        // Indexed by the position of the states in the double array, with 256 free entries past the last base
+        std::vector<node> nodes_;
+        // Patterns ending at state s, without the ones of its fail chain: ids_[outputs_[s]..outputs_[s+1])
+        std::vector<size_t> outputs_;
+        std::vector<size_t> ids_;
+        std::vector<size_t> lengths_;
+        size_t states_ = 0;
+};
+
+
+template<typename Iter>
+AhoCorasick::AhoCorasick(Iter first, Iter last)
+{
+    std::vector<std::string> patterns;
+    for(; first != last; ++first)
+    {
+        std::string p;
+        for(const auto& c : *first)
+            p.push_back(static_cast<char>(c));
+        patterns.push_back(std::move(p));
+    }
+
+    build(patterns);
+}
+
+
+inline int32_t AhoCorasick::next(int32_t s, unsigned char c) const noexcept
+{
+    for(;;)
+    {
+        const int32_t t = nodes_[s].base + c;
+        if(nodes_[t].check == s)
+            return t;
+        if(s == 0)
+            return 0;
+        s = nodes_[s].fail;
+    }
+}
+
+
+template<typename Iter2, typename F>
+void AhoCorasick::for_each_match(Iter2 first, Iter2 last, F&& f) const
+{
+    int32_t s = 0;
+    for(size_t end = 1; first != last; ++first, ++end)
+    {
+        s = next(s, static_cast<unsigned char>(*first));
+        for(int32_t r = nodes_[s].report; r >= 0; r = nodes_[nodes_[r].fail].report)
+            for(size_t k = outputs_[r]; k < outputs_[r + 1]; ++k)
+                f(ids_[k], end - lengths_[ids_[k]]);
+    }
+}
+
+
+template<typename Iter2>
+std::vector<AhoCorasick::match> AhoCorasick::find_all(Iter2 first, Iter2 last) const
+{
+    std::vector<match> matches;
+    for_each_match(first, last, [&matches](size_t pattern, size_t offset) { matches.push_back({pattern, offset}); });
+    return matches;
+}
+
+#endif //UTILITIES_AHO_CORASICK_HPP
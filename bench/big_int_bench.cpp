@@ -0,0 +1,236 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+// Cost of every UInt operator from 64 to 8192 bits, in nanoseconds per operation. Each operation is timed twice:
+// at run time on operands the compiler cannot see, then with its result evaluated during compilation (constexpr
+// operands), which leaves only the copy of the result: the second table is the floor of the loop and tells which
+// expressions the compiler can fold. Divisors have half the bits of the dividend, shift counts are about N / 3
+// Usage: big_int_bench [milliseconds per measure]
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "big_int.hpp"
+
+
+namespace
+{
+    constexpr size_t operand_count = 16;
+    double measure_ms = 10;
+
+    // Makes x opaque to the optimizer so that the computation of x cannot be dropped or hoisted
+    template<typename T>
+    inline void keep(const T& x) noexcept
+    {
+#if defined(__GNUC__)
+        asm volatile("" : : "r"(&x) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &x;
+#endif
+    }
+
+    // Nanoseconds per call of f(i), the count doubling until a run lasts measure_ms
+    template<typename F>
+    double measure(F f)
+    {
+        using clock = std::chrono::steady_clock;
+        for(size_t count = 16;; count *= 2)
+        {
+            const auto start = clock::now();
+            for(size_t i = 0; i < count; ++i)
+                f(i);
+            const std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+            if(elapsed.count() >= measure_ms * 1e6)
+                return elapsed.count() / static_cast<double>(count);
+        }
+    }
+
+    // Pseudo-random operand usable in constant expressions
+    template<size_t N>
+    constexpr UInt<N> constant_operand(uint64_t seed) noexcept
+    {
+        UInt<N> r;
+        for(size_t i = 0; i < (N + 63) / 64; ++i)
+        {
+            seed = seed * 6364136223846793005u + 1442695040888963407u;
+            r = (r << 64) | UInt<N>(seed ^ (seed >> 29));
+        }
+        return r;
+    }
+
+    template<size_t N>
+    UInt<N> random_operand(std::mt19937_64& rng)
+    {
+        UInt<N> r;
+        for(size_t i = 0; i < (N + 63) / 64; ++i)
+            r = (r << 64) | UInt<N>(rng());
+        return r;
+    }
+
+    // Decimal digits of a, for from_chars
+    template<size_t N>
+    struct digits
+    {
+        std::array<char, N * 30103 / 100000 + 2> chars{};
+        size_t size = 0;
+    };
+
+    template<size_t N>
+    constexpr digits<N> decimal(const UInt<N>& a) noexcept
+    {
+        digits<N> d;
+        d.size = static_cast<size_t>(to_chars(d.chars.data(), d.chars.data() + d.chars.size(), a).ptr - d.chars.data());
+        return d;
+    }
+
+    struct row
+    {
+        std::string name;
+        std::vector<double> run_time, compile_time;
+    };
+
+    std::vector<row> rows;
+
+    void record(const char* name, double run_time, double compile_time)
+    {
+        auto it = rows.begin();
+        while(it != rows.end() && it->name != name)
+            ++it;
+        if(it == rows.end())
+            it = rows.insert(it, {name, {}, {}});
+        it->run_time.push_back(run_time);
+        it->compile_time.push_back(compile_time);
+    }
+
+    // op(a, b) timed on the operand tables, then the copy of its value on constant operands
+    template<typename Op, typename A, typename B, typename R>
+    void bench(const char* name, Op op, const std::vector<A>& a, const std::vector<B>& b, const R& folded)
+    {
+        const double run_time = measure([&](size_t i) {
+            const auto r = op(a[i % operand_count], b[i % operand_count]);
+            keep(r);
+        });
+        const double compile_time = measure([&](size_t) {
+            const auto r = folded;
+            keep(r);
+        });
+        record(name, run_time, compile_time);
+    }
+
+    // The constexpr variable makes the compilation fail if op(ca, cb) cannot be evaluated in a constant expression
+#define BENCH(name, op, a, b, ca, cb) \
+    do { \
+        constexpr auto folded = op(ca, cb); \
+        bench(name, op, a, b, folded); \
+    } while(false)
+
+    template<size_t N>
+    void bench_width(std::mt19937_64& rng)
+    {
+        constexpr size_t shift = N / 3 + 1;
+        constexpr UInt<N> ca = constant_operand<N>(1);
+        constexpr UInt<N> cb = constant_operand<N>(2);
+        constexpr UInt<N> cd = (constant_operand<N>(3) >> (N / 2)) | UInt<N>(1);
+        constexpr uint64_t cw = 0x9e3779b97f4a7c15u;
+        constexpr auto cs = decimal(ca);
+
+        std::vector<UInt<N>> a, b, d;
+        std::vector<uint64_t> w;
+        std::vector<size_t> n;
+        std::vector<digits<N>> s;
+        for(size_t i = 0; i < operand_count; ++i)
+        {
+            a.push_back(random_operand<N>(rng));
+            b.push_back(random_operand<N>(rng));
+            d.push_back((random_operand<N>(rng) >> (N / 2)) | UInt<N>(1));
+            w.push_back(rng() | 1);
+            n.push_back(shift);
+            s.push_back(decimal(a.back()));
+        }
+
+        BENCH("~a", [](const auto& x, const auto&) { return ~x; }, a, b, ca, cb);
+        BENCH("a & b", [](const auto& x, const auto& y) { return x & y; }, a, b, ca, cb);
+        BENCH("a | b", [](const auto& x, const auto& y) { return x | y; }, a, b, ca, cb);
+        BENCH("a ^ b", [](const auto& x, const auto& y) { return x ^ y; }, a, b, ca, cb);
+        BENCH("a &= b", [](auto x, const auto& y) { return x &= y; }, a, b, ca, cb);
+        BENCH("a |= b", [](auto x, const auto& y) { return x |= y; }, a, b, ca, cb);
+        BENCH("a ^= b", [](auto x, const auto& y) { return x ^= y; }, a, b, ca, cb);
+        BENCH("a << n", [](const auto& x, size_t k) { return x << k; }, a, n, ca, shift);
+        BENCH("a >> n", [](const auto& x, size_t k) { return x >> k; }, a, n, ca, shift);
+        BENCH("a <<= n", [](auto x, size_t k) { return x <<= k; }, a, n, ca, shift);
+        BENCH("a >>= n", [](auto x, size_t k) { return x >>= k; }, a, n, ca, shift);
+        BENCH("a == b", [](const auto& x, const auto& y) { return x == y; }, a, a, ca, ca);
+        BENCH("a < b", [](const auto& x, const auto& y) { return x < y; }, a, a, ca, ca);
+        BENCH("compare", [](const auto& x, const auto& y) { return compare(x, y); }, a, a, ca, ca);
+        BENCH("bit_width", [](const auto& x, const auto&) { return bit_width(x); }, d, b, cd, cb);
+        BENCH("popcount", [](const auto& x, const auto&) { return popcount(x); }, a, b, ca, cb);
+        BENCH("a + b", [](const auto& x, const auto& y) { return x + y; }, a, b, ca, cb);
+        BENCH("a - b", [](const auto& x, const auto& y) { return x - y; }, a, b, ca, cb);
+        BENCH("a += b", [](auto x, const auto& y) { return x += y; }, a, b, ca, cb);
+        BENCH("a -= b", [](auto x, const auto& y) { return x -= y; }, a, b, ca, cb);
+        BENCH("a + w", [](const auto& x, uint64_t y) { return x + y; }, a, w, ca, cw);
+        BENCH("a - w", [](const auto& x, uint64_t y) { return x - y; }, a, w, ca, cw);
+        BENCH("a * b", [](const auto& x, const auto& y) { return x * y; }, a, b, ca, cb);
+        BENCH("a *= b", [](auto x, const auto& y) { return x *= y; }, a, b, ca, cb);
+        BENCH("a * w", [](const auto& x, uint64_t y) { return x * y; }, a, w, ca, cw);
+        BENCH("sqr", [](const auto& x, const auto&) { return sqr(x); }, a, b, ca, cb);
+        BENCH("wide_mul", [](const auto& x, const auto& y) { return wide_mul(x, y); }, a, b, ca, cb);
+        BENCH("wide_sqr", [](const auto& x, const auto&) { return wide_sqr(x); }, a, b, ca, cb);
+        BENCH("a / b", [](const auto& x, const auto& y) { return x / y; }, a, d, ca, cd);
+        BENCH("a % b", [](const auto& x, const auto& y) { return x % y; }, a, d, ca, cd);
+        BENCH("a /= b", [](auto x, const auto& y) { return x /= y; }, a, d, ca, cd);
+        BENCH("a %= b", [](auto x, const auto& y) { return x %= y; }, a, d, ca, cd);
+        BENCH("divmod", [](const auto& x, const auto& y) { return divmod(x, y); }, a, d, ca, cd);
+        BENCH("a / w", [](const auto& x, uint64_t y) { return x / y; }, a, w, ca, cw);
+        BENCH("a % w", [](const auto& x, uint64_t y) { return x % y; }, a, w, ca, cw);
+        BENCH("to_chars", [](const auto& x, const auto&) { return decimal(x); }, a, b, ca, cb);
+        BENCH("from_chars", [](const auto& x, const auto&) {
+            UInt<N> r;
+            from_chars(x.chars.data(), x.chars.data() + x.size, r);
+            return r;
+        }, s, b, cs, cb);
+    }
+
+    void print(const char* title, std::vector<double> row::*column)
+    {
+        std::printf("\n%s, ns/op\n%-12s", title, "");
+        for(size_t bits = 64; bits <= 8192; bits *= 2)
+            std::printf("%11zu", bits);
+        std::printf("\n");
+        for(const auto& r : rows)
+        {
+            std::printf("%-12s", r.name.c_str());
+            for(const double t : r.*column)
+                std::printf(t < 100 ? "%11.2f" : "%11.0f", t);
+            std::printf("\n");
+        }
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    if(argc > 1)
+        measure_ms = std::atof(argv[1]);
+
+    std::mt19937_64 rng(1);
+    bench_width<64>(rng);
+    bench_width<128>(rng);
+    bench_width<256>(rng);
+    bench_width<512>(rng);
+    bench_width<1024>(rng);
+    bench_width<2048>(rng);
+    bench_width<4096>(rng);
+    bench_width<8192>(rng);
+
+    print("Run time", &row::run_time);
+    print("Evaluated at compile time", &row::compile_time);
+
+    return 0;
+}
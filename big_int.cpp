@@ -3,3 +3,455 @@
 //
 
 #include "big_int.hpp"
+#include <memory>
+#include <cctype>
+#include <stdexcept>
+
+
+namespace
+{
+    // Scratch space of the kernels, on the stack when it is small enough
+    class scratch_buffer
+    {
+        public:
+            explicit scratch_buffer(size_t n) : heap_{n > local_size ? new uint64_t[n] : nullptr} {}
+
+            uint64_t* get() noexcept { return heap_ ? heap_.get() : local_; }
+
+        private:
+            static constexpr size_t local_size = 256;
+
+            uint64_t local_[local_size];
+            std::unique_ptr<uint64_t[]> heap_;
+    };
+}
+
+
+// Constructors
+BigInt::BigInt(const BigInt& a) : BigInt()
+{
+    *this = a;
+}
+
+BigInt::BigInt(BigInt&& a) noexcept : BigInt()
+{
+    *this = std::move(a);
+}
+
+BigInt::~BigInt()
+{
+    if(capacity_ > inline_limbs)
+        delete[] heap_;
+}
+
+
+// Assignment operators
+BigInt& BigInt::operator=(const BigInt& a)
+{
+    if(this != &a)
+    {
+        // Nothing of the current value has to be kept if the storage grows
+        size_ = 0;
+        reserve(a.size_);
+        implementation_detail::copy(mutable_limbs(), a.limbs(), a.size_);
+        size_ = a.size_;
+        negative_ = a.negative_;
+    }
+
+    return *this;
+}
+
+BigInt& BigInt::operator=(BigInt&& a) noexcept
+{
+    if(this != &a)
+    {
+        if(capacity_ > inline_limbs)
+            delete[] heap_;
+
+        size_ = a.size_;
+        capacity_ = a.capacity_;
+        negative_ = a.negative_;
+        if(capacity_ > inline_limbs)
+            heap_ = a.heap_;
+        else
+            implementation_detail::copy(inline_, a.inline_, size_);
+
+        a.size_ = 0;
+        a.capacity_ = inline_limbs;
+        a.negative_ = false;
+    }
+
+    return *this;
+}
+
+
+// Storage
+void BigInt::reserve(size_t n)
+{
+    if(n <= capacity_)
+        return;
+
+    // Growing geometrically keeps the repeated in-place operations amortized
+    const size_t capacity = std::max(n, 2 * capacity_);
+    uint64_t* limbs = new uint64_t[capacity];
+    implementation_detail::copy(limbs, mutable_limbs(), size_);
+    if(capacity_ > inline_limbs)
+        delete[] heap_;
+    heap_ = limbs;
+    capacity_ = capacity;
+}
+
+void BigInt::normalize() noexcept
+{
+    size_ = implementation_detail::significant(mutable_limbs(), size_);
+    negative_ = negative_ && size_ != 0;
+}
+
+
+// +, +=, -, -= operators
+void BigInt::add_signed(const BigInt& a, bool negative)
+{
+    // a may be *this, its size is read before the storage moves and its limbs after
+    const size_t na = a.size_;
+    const size_t n = std::max(size_, na);
+    if(negative_ == negative)
+    {
+        reserve(n + 1);
+        uint64_t* r = mutable_limbs();
+        const uint64_t* b = a.limbs();
+        r[n] = size_ >= na ? implementation_detail::add(r, r, size_, b, na)
+                           : implementation_detail::add(r, b, na, r, size_);
+        size_ = n + 1;
+    }
+    else
+    {
+        // The magnitudes are subtracted, the sign being the one of the larger
+        reserve(n);
+        uint64_t* r = mutable_limbs();
+        const uint64_t* b = a.limbs();
+        const bool below = size_ >= na ? implementation_detail::sub_abs(r, r, size_, b, na)
+                                       : !implementation_detail::sub_abs(r, b, na, r, size_);
+        if(below)
+            negative_ = negative;
+        size_ = n;
+    }
+    normalize();
+}
+
+BigInt& BigInt::operator+=(const BigInt& a)
+{
+    add_signed(a, a.negative_);
+    return *this;
+}
+
+BigInt& BigInt::operator-=(const BigInt& a)
+{
+    add_signed(a, !a.negative_);
+    return *this;
+}
+
+BigInt operator-(BigInt a) noexcept
+{
+    a.negative_ = !a.negative_ && a.size_ != 0;
+    return a;
+}
+
+BigInt operator+(const BigInt& a, const BigInt& b)
+{
+    BigInt result = a;
+    result += b;
+    return result;
+}
+
+BigInt operator-(const BigInt& a, const BigInt& b)
+{
+    BigInt result = a;
+    result -= b;
+    return result;
+}
+
+
+// *, *= operators
+BigInt operator*(const BigInt& a, const BigInt& b)
+{
+    BigInt result;
+    if(a.size_ == 0 || b.size_ == 0)
+        return result;
+
+    result.reserve(a.size_ + b.size_);
+    uint64_t* r = result.mutable_limbs();
+    const size_t n = std::min(a.size_, b.size_);
+    if(&a == &b)
+    {
+        scratch_buffer scratch(implementation_detail::mul_scratch(n));
+        implementation_detail::sqr_n(r, a.limbs(), n, scratch.get());
+    }
+    else if(n >= implementation_detail::karatsuba_threshold)
+    {
+        scratch_buffer scratch(implementation_detail::mul_any_scratch(n));
+        implementation_detail::mul_any(r, a.limbs(), a.size_, b.limbs(), b.size_, scratch.get());
+    }
+    else
+        implementation_detail::mul(r, a.limbs(), a.size_, b.limbs(), b.size_);
+
+    result.size_ = a.size_ + b.size_;
+    result.negative_ = a.negative_ != b.negative_;
+    result.normalize();
+
+    return result;
+}
+
+BigInt& BigInt::operator*=(const BigInt& a)
+{
+    return *this = *this * a;
+}
+
+
+// divmod, /, /=, %, %= operators
+std::pair<BigInt, BigInt> divmod(const BigInt& a, const BigInt& b)
+{
+    if(b.size_ == 0)
+        throw std::domain_error("");
+
+    std::pair<BigInt, BigInt> result;
+    auto& [q, r] = result;
+    if(a.size_ < b.size_ || implementation_detail::cmp(a.limbs(), a.size_, b.limbs(), b.size_) < 0)
+    {
+        r = a;
+        return result;
+    }
+
+    q.reserve(a.size_ - b.size_ + 1);
+    r.reserve(b.size_);
+    scratch_buffer scratch(implementation_detail::div_scratch(a.size_, b.size_));
+    implementation_detail::divrem(q.mutable_limbs(), r.mutable_limbs(), a.limbs(), a.size_, b.limbs(), b.size_,
+                                  scratch.get());
+    q.size_ = a.size_ - b.size_ + 1;
+    r.size_ = b.size_;
+    q.negative_ = a.negative_ != b.negative_;
+    r.negative_ = a.negative_;
+    q.normalize();
+    r.normalize();
+
+    return result;
+}
+
+BigInt operator/(const BigInt& a, const BigInt& b)
+{
+    return divmod(a, b).first;
+}
+
+BigInt operator%(const BigInt& a, const BigInt& b)
+{
+    return divmod(a, b).second;
+}
+
+BigInt& BigInt::operator/=(const BigInt& a)
+{
+    return *this = divmod(*this, a).first;
+}
+
+BigInt& BigInt::operator%=(const BigInt& a)
+{
+    return *this = divmod(*this, a).second;
+}
+
+
+// <<, <<=, >>, >>= operators
+BigInt& BigInt::operator<<=(size_t n)
+{
+    if(size_ == 0)
+        return *this;
+
+    const size_t offset = n / 64;
+    const unsigned bits = n % 64;
+    reserve(size_ + offset + 1);
+    uint64_t* r = mutable_limbs();
+    if(bits != 0)
+        r[size_ + offset] = implementation_detail::lshift(r + offset, r, size_, bits);
+    else
+    {
+        r[size_ + offset] = 0;
+        for(size_t i = size_; i-- > 0;)
+            r[i + offset] = r[i];
+    }
+    implementation_detail::zero(r, offset);
+    size_ += offset + 1;
+    normalize();
+
+    return *this;
+}
+
+BigInt& BigInt::operator>>=(size_t n)
+{
+    const size_t offset = n / 64;
+    const unsigned bits = n % 64;
+    if(offset >= size_)
+        return *this = negative_ ? BigInt(-1) : BigInt();
+
+    // The negative values round toward minus infinity, their magnitude going up when set bits are shifted out
+    uint64_t* r = mutable_limbs();
+    bool inexact = implementation_detail::significant(r, offset) != 0;
+    if(bits != 0)
+        inexact |= implementation_detail::rshift(r, r + offset, size_ - offset, bits) != 0;
+    else
+        implementation_detail::copy(r, r + offset, size_ - offset);
+    size_ -= offset;
+    // The carry out only happens for a whole limb shift, which freed the room for it
+    if(negative_ && inexact && implementation_detail::add_1(r, r, size_, 1) != 0)
+        r[size_++] = 1;
+    normalize();
+
+    return *this;
+}
+
+BigInt operator<<(const BigInt& a, size_t n)
+{
+    BigInt result = a;
+    result <<= n;
+    return result;
+}
+
+BigInt operator>>(const BigInt& a, size_t n)
+{
+    BigInt result = a;
+    result >>= n;
+    return result;
+}
+
+
+// Comparison operators
+int compare(const BigInt& a, const BigInt& b) noexcept
+{
+    if(a.is_negative() != b.is_negative())
+        return a.is_negative() ? -1 : 1;
+
+    const int magnitude = a.size() != b.size() ? (a.size() < b.size() ? -1 : 1)
+                                               : implementation_detail::cmp(a.limbs(), a.size(), b.limbs(), b.size());
+    return a.is_negative() ? -magnitude : magnitude;
+}
+
+
+// String conversions
+std::to_chars_result to_chars(char* first, char* last, const BigInt& value, int base)
+{
+    char* out = first;
+    if(value.is_negative())
+    {
+        if(out == last)
+            return {last, std::errc::value_too_large};
+        *out++ = '-';
+    }
+
+    scratch_buffer scratch(implementation_detail::to_chars_scratch(value.size()));
+    char* end = implementation_detail::to_chars(out, last, value.limbs(), value.size(), static_cast<unsigned>(base),
+                                                scratch.get());
+    if(end == nullptr)
+        return {last, std::errc::value_too_large};
+
+    return {end, std::errc()};
+}
+
+std::from_chars_result from_chars(const char* first, const char* last, BigInt& value, int base)
+{
+    const bool negative = first != last && *first == '-';
+    const char* digits = first + negative;
+    const char* end = digits;
+    while(end != last && implementation_detail::digit_value(*end) < static_cast<unsigned>(base))
+        ++end;
+    if(end == digits)
+        return {first, std::errc::invalid_argument};
+
+    while(digits + 1 != end && *digits == '0')
+        ++digits;
+    size_t chunk_digits = 0;
+    implementation_detail::chunk_base(static_cast<unsigned>(base), chunk_digits);
+    const size_t count = static_cast<size_t>(end - digits);
+
+    BigInt result;
+    result.reserve((count + chunk_digits - 1) / chunk_digits);
+    scratch_buffer scratch(implementation_detail::from_chars_scratch((count + chunk_digits - 1) / chunk_digits));
+    result.size_ = implementation_detail::from_chars(result.mutable_limbs(), digits, count,
+                                                     static_cast<unsigned>(base), scratch.get());
+    result.negative_ = negative && result.size_ != 0;
+    value = std::move(result);
+
+    return {end, std::errc()};
+}
+
+std::ostream& operator<<(std::ostream& out, const BigInt& n)
+{
+    const auto flags = out.flags();
+    const int base = (flags & std::ios::hex) ? 16 : (flags & std::ios::oct) ? 8 : 10;
+
+    // Octal takes the most digits, plus the sign
+    std::string buffer(64 * n.size() / 3 + 2, '\0');
+    const auto result = to_chars(buffer.data(), buffer.data() + buffer.size(), n, base);
+    if(flags & std::ios::uppercase)
+        for(char* c = buffer.data(); c != result.ptr; ++c)
+            *c = static_cast<char>(std::toupper(static_cast<unsigned char>(*c)));
+    out << std::string_view(buffer.data(), static_cast<size_t>(result.ptr - buffer.data()));
+
+    return out;
+}
+
+// Reads an optional '-' then the digits in the base of the stream, sets failbit when there are none
+std::istream& operator>>(std::istream& in, BigInt& n)
+{
+    std::istream::sentry sentry(in);
+    if(!sentry)
+        return in;
+
+    const auto flags = in.flags();
+    const int base = (flags & std::ios::hex) ? 16 : (flags & std::ios::oct) ? 8 : 10;
+    std::string digits;
+    if(in.peek() == '-')
+        digits.push_back(static_cast<char>(in.get()));
+    for(;;)
+    {
+        const auto c = in.peek();
+        if(c == std::istream::traits_type::eof())
+        {
+            in.setstate(std::ios::eofbit);
+            break;
+        }
+        if(implementation_detail::digit_value(static_cast<char>(c)) >= static_cast<unsigned>(base))
+            break;
+        digits.push_back(static_cast<char>(in.get()));
+    }
+
+    if(from_chars(digits.data(), digits.data() + digits.size(), n, base).ec != std::errc())
+        in.setstate(std::ios::failbit);
+
+    return in;
+}
+
+
+// Explicit instantiations for the usual widths, so that every member of the templates is compiled along with the
+// library and not only the ones a program happens to use
+template class UInt<64>;
+template class UInt<128>;
+template class UInt<256>;
+template class UInt<512>;
+template class UInt<1024>;
+template class UInt<2048>;
+template class UInt<4096>;
+template class UInt<8192>;
+
+template class Montgomery<64>;
+template class Montgomery<128>;
+template class Montgomery<256>;
+template class Montgomery<512>;
+template class Montgomery<1024>;
+template class Montgomery<2048>;
+template class Montgomery<4096>;
+template class Montgomery<8192>;
+
+template class Barrett<64>;
+template class Barrett<128>;
+template class Barrett<256>;
+template class Barrett<512>;
+template class Barrett<1024>;
+template class Barrett<2048>;
+template class Barrett<4096>;
+template class Barrett<8192>;
@@ -7,6 +7,62 @@
 
 #include <iostream>
 #include <iomanip>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <system_error>
+#include <type_traits>
+
+// The carry and multiply intrinsics are only used outside of constant evaluation
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#include <immintrin.h>
+#define UTILITIES_BIG_INT_INTRINSICS
+#endif
+#endif
+
+// The constant-time code hides its masks from the optimizer so that they are not turned back into branches
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define UTILITIES_BIG_INT_VALUE_BARRIER
+#endif
+#endif
+
+// <=> is provided on top of the other comparison operators when the compiler supports it
+#if defined(__cpp_impl_three_way_comparison) && defined(__has_include)
+#if __has_include(<compare>)
+#include <compare>
+#define UTILITIES_BIG_INT_THREE_WAY_COMPARISON
+#endif
+#endif
+
+// Sizes, in limbs, from which the multiplication switches to Karatsuba, to Toom-3 then to the number-theoretic
+// transform. They can be tuned by defining them before the inclusion of this file
+#ifndef UTILITIES_BIG_INT_KARATSUBA_THRESHOLD
+#define UTILITIES_BIG_INT_KARATSUBA_THRESHOLD 24
+#endif
+#ifndef UTILITIES_BIG_INT_TOOM3_THRESHOLD
+#define UTILITIES_BIG_INT_TOOM3_THRESHOLD 192
+#endif
+#ifndef UTILITIES_BIG_INT_NTT_THRESHOLD
+#define UTILITIES_BIG_INT_NTT_THRESHOLD 1024
+#endif
+// The schoolbook square doing half of the work of a product, squares switch to Karatsuba later
+#ifndef UTILITIES_BIG_INT_SQR_KARATSUBA_THRESHOLD
+#define UTILITIES_BIG_INT_SQR_KARATSUBA_THRESHOLD 48
+#endif
+// Divisor size, in limbs, from which the division recurses (Burnikel-Ziegler), and size of the powers of the base
+// from which the conversions to and from strings are divided and conquered
+#ifndef UTILITIES_BIG_INT_DIV_DC_THRESHOLD
+#define UTILITIES_BIG_INT_DIV_DC_THRESHOLD 48
+#endif
+#ifndef UTILITIES_BIG_INT_CONVERSION_THRESHOLD
+#define UTILITIES_BIG_INT_CONVERSION_THRESHOLD 16
+#endif
 
 
 template<int N>
@@ -16,517 +72,3612 @@ constexpr size_t ceil_div(const size_t& n)
 }
 
 
+namespace implementation_detail
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+    // a + b + carry, carry being updated to the carry out (0 or 1)
+    constexpr uint64_t add_carry(uint64_t a, uint64_t b, uint64_t& carry) noexcept
+    {
+#ifdef UTILITIES_BIG_INT_INTRINSICS
+        if(!__builtin_is_constant_evaluated())
+        {
+            unsigned long long r = 0;
+            carry = _addcarry_u64(static_cast<unsigned char>(carry), a, b, &r);
+            return r;
+        }
+#endif
+        const uint64_t s = a + b;
+        const uint64_t r = s + carry;
+        carry = (s < a) | (r < s);
+        return r;
+    }
+
+    // a - b - borrow, borrow being updated to the borrow out (0 or 1)
+    constexpr uint64_t sub_borrow(uint64_t a, uint64_t b, uint64_t& borrow) noexcept
+    {
+#ifdef UTILITIES_BIG_INT_INTRINSICS
+        if(!__builtin_is_constant_evaluated())
+        {
+            unsigned long long r = 0;
+            borrow = _subborrow_u64(static_cast<unsigned char>(borrow), a, b, &r);
+            return r;
+        }
+#endif
+        const uint64_t d = a - b;
+        const uint64_t r = d - borrow;
+        borrow = (a < b) | (d < borrow);
+        return r;
+    }
+
+    // Full 64x64 -> 128 bits product, returns the low half and stores the high one in hi
+    constexpr uint64_t mul_wide(uint64_t a, uint64_t b, uint64_t& hi) noexcept
+    {
+#if defined(UTILITIES_BIG_INT_INTRINSICS) && defined(__BMI2__)
+        if(!__builtin_is_constant_evaluated())
+        {
+            unsigned long long h = 0;
+            const uint64_t lo = _mulx_u64(a, b, &h);
+            hi = h;
+            return lo;
+        }
+#endif
+#ifdef __SIZEOF_INT128__
+        const uint128_t p = static_cast<uint128_t>(a) * b;
+        hi = static_cast<uint64_t>(p >> 64);
+        return static_cast<uint64_t>(p);
+#else
+        const uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+        const uint64_t b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+        const uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+        const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+        hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+        return (mid << 32) | (ll & 0xFFFFFFFF);
+#endif
+    }
+
+    // r[0..n) = a[0..n) + b[0..n), returns the carry out
+    constexpr uint64_t add_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n) noexcept
+    {
+        uint64_t carry = 0;
+        for(size_t i = 0; i < n; ++i)
+            r[i] = add_carry(a[i], b[i], carry);
+        return carry;
+    }
+
+    // r[0..n) = a[0..n) + b, returns the carry out
+    constexpr uint64_t add_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b) noexcept
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            r[i] = a[i] + b;
+            b = r[i] < b;
+        }
+        return b;
+    }
+
+    // r[0..na) = a[0..na) + b[0..nb) with na >= nb, returns the carry out
+    constexpr uint64_t add(uint64_t* r, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) noexcept
+    {
+        const uint64_t carry = add_n(r, a, b, nb);
+        return add_1(r + nb, a + nb, na - nb, carry);
+    }
+
+    // r[0..n) = a[0..n) - b[0..n), returns the borrow out
+    constexpr uint64_t sub_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n) noexcept
+    {
+        uint64_t borrow = 0;
+        for(size_t i = 0; i < n; ++i)
+            r[i] = sub_borrow(a[i], b[i], borrow);
+        return borrow;
+    }
+
+    // r[0..n) = a[0..n) - b, returns the borrow out
+    constexpr uint64_t sub_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b) noexcept
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            const uint64_t ai = a[i];
+            r[i] = ai - b;
+            b = ai < b;
+        }
+        return b;
+    }
+
+    // r[0..na) = a[0..na) - b[0..nb) with na >= nb, returns the borrow out
+    constexpr uint64_t sub(uint64_t* r, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) noexcept
+    {
+        const uint64_t borrow = sub_n(r, a, b, nb);
+        return sub_1(r + nb, a + nb, na - nb, borrow);
+    }
+
+    // r[0..n) = a[0..n) * b, returns the high limb of the product
+    constexpr uint64_t mul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b) noexcept
+    {
+        uint64_t carry = 0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            uint64_t hi = 0;
+            const uint64_t lo = mul_wide(a[i], b, hi) + carry;
+            carry = hi + (lo < carry);
+            r[i] = lo;
+        }
+        return carry;
+    }
+
+    // r[0..n) += a[0..n) * b, returns the limb carried out
+    constexpr uint64_t addmul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b) noexcept
+    {
+        uint64_t carry = 0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            uint64_t hi = 0;
+            uint64_t lo = mul_wide(a[i], b, hi) + carry;
+            hi += lo < carry;
+            lo += r[i];
+            carry = hi + (lo < r[i]);
+            r[i] = lo;
+        }
+        return carry;
+    }
+
+    // r[0..n) -= a[0..n) * b, returns the limb borrowed out
+    constexpr uint64_t submul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b) noexcept
+    {
+        uint64_t carry = 0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            uint64_t hi = 0;
+            const uint64_t lo = mul_wide(a[i], b, hi) + carry;
+            hi += lo < carry;
+            const uint64_t ri = r[i];
+            r[i] = ri - lo;
+            carry = hi + (ri < lo);
+        }
+        return carry;
+    }
+
+    // r[0..n) = the n low limbs of a[0..na) * b[0..nb), one row of partial products accumulated per limb of b.
+    // r must not overlap a or b
+    constexpr void mul_low(uint64_t* r, const uint64_t* a, size_t na, const uint64_t* b, size_t nb, size_t n) noexcept
+    {
+        for(size_t i = 0; i < n; ++i)
+            r[i] = 0;
+        for(size_t j = 0; j < std::min(nb, n); ++j)
+        {
+            const size_t len = std::min(na, n - j);
+            const uint64_t carry = addmul_1(r + j, a, len, b[j]);
+            if(j + len < n)
+                r[j + len] = carry;
+        }
+    }
+
+    // r[0..na+nb) = a[0..na) * b[0..nb), r must not overlap a or b
+    constexpr void mul(uint64_t* r, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) noexcept
+    {
+        r[na] = mul_1(r, a, na, b[0]);
+        for(size_t j = 1; j < nb; ++j)
+            r[na + j] = addmul_1(r + j, a, na, b[j]);
+    }
+
+    constexpr void copy(uint64_t* r, const uint64_t* a, size_t n) noexcept
+    {
+        for(size_t i = 0; i < n; ++i)
+            r[i] = a[i];
+    }
+
+    constexpr void zero(uint64_t* r, size_t n) noexcept
+    {
+        for(size_t i = 0; i < n; ++i)
+            r[i] = 0;
+    }
+
+    // Compares a[0..na) and b[0..nb) with na >= nb, returns -1, 0 or 1
+    constexpr int cmp(const uint64_t* a, size_t na, const uint64_t* b, size_t nb) noexcept
+    {
+        for(size_t i = na; i > nb; --i)
+            if(a[i-1] != 0)
+                return 1;
+        for(size_t i = nb; i > 0; --i)
+            if(a[i-1] != b[i-1])
+                return a[i-1] < b[i-1] ? -1 : 1;
+        return 0;
+    }
+
+    // r[0..n) = a[0..n) << s with 0 < s < 64, returns the bits shifted out. r may be equal to or above a
+    constexpr uint64_t lshift(uint64_t* r, const uint64_t* a, size_t n, unsigned s) noexcept
+    {
+        const uint64_t out = a[n-1] >> (64 - s);
+        for(size_t i = n - 1; i > 0; --i)
+            r[i] = (a[i] << s) | (a[i-1] >> (64 - s));
+        r[0] = a[0] << s;
+        return out;
+    }
+
+    // r[0..n) = a[0..n) >> s with 0 < s < 64, returns the bits shifted out (in the high bits). r may be equal to or below a
+    constexpr uint64_t rshift(uint64_t* r, const uint64_t* a, size_t n, unsigned s) noexcept
+    {
+        const uint64_t out = a[0] << (64 - s);
+        for(size_t i = 0; i + 1 < n; ++i)
+            r[i] = (a[i] >> s) | (a[i+1] << (64 - s));
+        r[n-1] = a[n-1] >> s;
+        return out;
+    }
+
+    // r[0..2n) = a[0..n)^2, every cross product being computed once then doubled. r must not overlap a
+    constexpr void sqr(uint64_t* r, const uint64_t* a, size_t n) noexcept
+    {
+        r[0] = 0;
+        r[2*n - 1] = 0;
+        r[n] = mul_1(r + 1, a + 1, n - 1, a[0]);
+        for(size_t i = 1; i + 1 < n; ++i)
+            r[n + i] = addmul_1(r + 2*i + 1, a + i + 1, n - i - 1, a[i]);
+
+        // 2 sum(a[i] a[j] for i < j) + sum(a[i]^2)
+        uint64_t carry = 0;
+        lshift(r, r, 2*n, 1);
+        for(size_t i = 0; i < n; ++i)
+        {
+            uint64_t hi = 0;
+            const uint64_t lo = mul_wide(a[i], a[i], hi);
+            r[2*i] = add_carry(r[2*i], lo, carry);
+            r[2*i + 1] = add_carry(r[2*i + 1], hi, carry);
+        }
+    }
+
+    // r[0..nr) = the nr low limbs of a[0..n)^2 with nr <= 2n, the cross products below nr being computed once then
+    // doubled. r must not overlap a
+    constexpr void sqr_low(uint64_t* r, const uint64_t* a, size_t n, size_t nr) noexcept
+    {
+        zero(r, nr);
+        for(size_t i = 0; i + 1 < n && 2*i + 1 < nr; ++i)
+        {
+            const size_t len = std::min(n - i - 1, nr - 2*i - 1);
+            const uint64_t carry = addmul_1(r + 2*i + 1, a + i + 1, len, a[i]);
+            // Nothing was written there yet
+            if(2*i + 1 + len < nr)
+                r[2*i + 1 + len] = carry;
+        }
+
+        uint64_t carry = 0;
+        lshift(r, r, nr, 1);
+        for(size_t i = 0; 2*i < nr; ++i)
+        {
+            uint64_t hi = 0;
+            const uint64_t lo = mul_wide(a[i], a[i], hi);
+            r[2*i] = add_carry(r[2*i], lo, carry);
+            if(2*i + 1 < nr)
+                r[2*i + 1] = add_carry(r[2*i + 1], hi, carry);
+        }
+    }
+
+    // r[0..n) += b, stopping as soon as the carry is absorbed. Returns the carry out
+    constexpr uint64_t propagate(uint64_t* r, size_t n, uint64_t b) noexcept
+    {
+        for(size_t i = 0; b != 0 && i < n; ++i)
+        {
+            r[i] += b;
+            b = r[i] < b;
+        }
+        return b;
+    }
+
+    // r[0..n) += the n low limbs of a[0..na) * b[0..nb), the carry out of r being dropped. r must not overlap a or b
+    constexpr void addmul_low(uint64_t* r, size_t n, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) noexcept
+    {
+        for(size_t j = 0; j < std::min(nb, n); ++j)
+        {
+            const size_t len = std::min(na, n - j);
+            const uint64_t carry = addmul_1(r + j, a, len, b[j]);
+            propagate(r + j + len, n - j - len, carry);
+        }
+    }
+
+    // r[0..n) = -a[0..n) modulo 2^(64n)
+    constexpr void neg(uint64_t* r, const uint64_t* a, size_t n) noexcept
+    {
+        uint64_t carry = 1;
+        for(size_t i = 0; i < n; ++i)
+        {
+            r[i] = ~a[i] + carry;
+            carry = carry && r[i] == 0;
+        }
+    }
+
+    // r[0..n) = a[0..n) / 3 for a multiple of 3. Computed modulo 2^(64n), so it also holds for two's complement values
+    constexpr void divexact_by3(uint64_t* r, const uint64_t* a, size_t n) noexcept
+    {
+        constexpr uint64_t inverse = 0xAAAAAAAAAAAAAAAB; // 3 * inverse == 1 modulo 2^64
+        uint64_t borrow = 0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            const uint64_t x = a[i] - borrow;
+            const uint64_t under = a[i] < borrow;
+            const uint64_t q = x * inverse;
+            r[i] = q;
+            mul_wide(q, 3, borrow);
+            borrow += under;
+        }
+    }
+
+    // r[0..na) = |a[0..na) - b[0..nb)| with na >= nb, returns true when a < b. r may be equal to a
+    constexpr bool sub_abs(uint64_t* r, const uint64_t* a, size_t na, const uint64_t* b, size_t nb) noexcept
+    {
+        if(cmp(a, na, b, nb) >= 0)
+        {
+            sub(r, a, na, b, nb);
+            return false;
+        }
+        // a < b so the limbs of a above nb are all zero
+        sub_n(r, b, a, nb);
+        zero(r + nb, na - nb);
+        return true;
+    }
+
+    // Number of limbs of a[0..n) once its high zero limbs are dropped
+    constexpr size_t significant(const uint64_t* a, size_t n) noexcept
+    {
+        while(n > 0 && a[n-1] == 0)
+            --n;
+        return n;
+    }
+
+    // Number of leading zero bits of a non-zero limb
+    constexpr unsigned clz(uint64_t a) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_clzll(a));
+#else
+        unsigned n = 0;
+        for(uint64_t bit = uint64_t(1) << 63; !(a & bit); bit >>= 1)
+            ++n;
+        return n;
+#endif
+    }
+
+    // Number of trailing zero bits of a non-zero limb
+    constexpr unsigned ctz(uint64_t a) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(a));
+#else
+        unsigned n = 0;
+        for(; !(a & 1); a >>= 1)
+            ++n;
+        return n;
+#endif
+    }
+
+    // Number of set bits of a limb. Without the popcnt instruction the builtin is a library call, slower than the
+    // bit twiddling which also vectorizes over the limbs
+    constexpr unsigned popcount(uint64_t a) noexcept
+    {
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__POPCNT__)
+        return static_cast<unsigned>(__builtin_popcountll(a));
+#else
+        a -= (a >> 1) & 0x5555555555555555;
+        a = (a & 0x3333333333333333) + ((a >> 2) & 0x3333333333333333);
+        a = (a + (a >> 4)) & 0x0F0F0F0F0F0F0F0F;
+        return static_cast<unsigned>((a * 0x0101010101010101) >> 56);
+#endif
+    }
+
+    // floor((2^128 - 1) / d) - 2^64 for a normalized d (high bit set), the reciprocal used by div_2by1
+    constexpr uint64_t reciprocal(uint64_t d) noexcept
+    {
+#ifdef __SIZEOF_INT128__
+        return static_cast<uint64_t>(~uint128_t(0) / d);
+#else
+        // 2^128 - 1 - 2^64 d = (~d, ~0), divided by schoolbook on 32 bits halves (Hacker's Delight divlu)
+        constexpr uint64_t b = uint64_t(1) << 32;
+        const uint64_t dh = d >> 32, dl = d & 0xFFFFFFFF;
+        const uint64_t uh = ~d, ul = ~uint64_t(0);
+
+        uint64_t q1 = uh / dh, rhat = uh - q1 * dh;
+        while(q1 >= b || q1 * dl > b * rhat + (ul >> 32))
+        {
+            --q1;
+            rhat += dh;
+            if(rhat >= b)
+                break;
+        }
+        const uint64_t mid = uh * b + (ul >> 32) - q1 * d;
+        uint64_t q0 = mid / dh;
+        rhat = mid - q0 * dh;
+        while(q0 >= b || q0 * dl > b * rhat + (ul & 0xFFFFFFFF))
+        {
+            --q0;
+            rhat += dh;
+            if(rhat >= b)
+                break;
+        }
+        return q1 * b + q0;
+#endif
+    }
+
+    // (uh, ul) / d for a normalized d and uh < d, v being reciprocal(d). Returns the quotient and stores the
+    // remainder in r. Division by multiplication from Moller and Granlund, "Improved division by invariant integers"
+    constexpr uint64_t div_2by1(uint64_t uh, uint64_t ul, uint64_t d, uint64_t v, uint64_t& r) noexcept
+    {
+        uint64_t q1 = 0, carry = 0;
+        uint64_t q0 = mul_wide(v, uh, q1);
+        q0 = add_carry(q0, ul, carry);
+        q1 += uh + 1 + carry;
+        r = ul - q1 * d;
+        if(r > q0)
+        {
+            --q1;
+            r += d;
+        }
+        if(r >= d)
+        {
+            ++q1;
+            r -= d;
+        }
+        return q1;
+    }
+
+    // q[0..n) = a[0..n) / d with d != 0, returns the remainder. q may be equal to a
+    constexpr uint64_t divrem_1(uint64_t* q, const uint64_t* a, size_t n, uint64_t d) noexcept
+    {
+        const unsigned s = clz(d);
+        d <<= s;
+        const uint64_t v = reciprocal(d);
+        uint64_t r = 0;
+        if(s == 0)
+        {
+            for(size_t i = n; i-- > 0;)
+                q[i] = div_2by1(r, a[i], d, v, r);
+            return r;
+        }
+        // The dividend is shifted on the fly by the same amount as the divisor
+        r = a[n-1] >> (64 - s);
+        for(size_t i = n; i-- > 0;)
+        {
+            const uint64_t limb = (a[i] << s) | (i > 0 ? a[i-1] >> (64 - s) : 0);
+            q[i] = div_2by1(r, limb, d, v, r);
+        }
+        return r >> s;
+    }
+
+    // Knuth's algorithm D (TAOCP vol. 2, 4.3.1), in place: q[0..nq) = u[0..nq+nd) / d[0..nd) and u[0..nd) = the
+    // remainder, with nd >= 2, d normalized (high bit set) and u[nq..nq+nd) < d. Normalization keeps each quotient
+    // limb estimated from the two high limbs of the divisor at most 2 above the actual one
+    constexpr void div_basecase(uint64_t* q, uint64_t* u, size_t nq, const uint64_t* d, size_t nd) noexcept
+    {
+        const uint64_t dh = d[nd-1], dl = d[nd-2], v = reciprocal(dh);
+        for(size_t j = nq; j-- > 0;)
+        {
+            uint64_t* w = u + j;
+            // w[nd] <= dh is an invariant, the estimate being clamped to the limb maximum on equality
+            uint64_t qhat = ~uint64_t(0), rhat = w[nd-1] + dh;
+            bool refine = rhat >= dh;
+            if(w[nd] < dh)
+            {
+                qhat = div_2by1(w[nd], w[nd-1], dh, v, rhat);
+                refine = true;
+            }
+            // Refines the estimate with the second limb of the divisor, as long as rhat fits in a limb
+            while(refine)
+            {
+                uint64_t hi = 0;
+                const uint64_t lo = mul_wide(qhat, dl, hi);
+                if(hi < rhat || (hi == rhat && lo <= w[nd-2]))
+                    break;
+                --qhat;
+                rhat += dh;
+                refine = rhat >= dh;
+            }
+
+            const uint64_t borrow = submul_1(w, d, nd, qhat);
+            const uint64_t top = w[nd];
+            w[nd] = top - borrow;
+            // The estimate was still one too large, which happens with a probability of about 2/2^64
+            if(top < borrow)
+            {
+                --qhat;
+                w[nd] += add_n(w, w, d, nd);
+            }
+            q[j] = qhat;
+        }
+    }
+
+    // r[0..n) = t[0..2n) / 2^(64n) modulo m[0..n) (Montgomery reduction), with t < 2^(64n) m, m odd and
+    // minv = -1/m modulo 2^64. t is used as workspace
+    constexpr void redc(uint64_t* r, uint64_t* t, const uint64_t* m, size_t n, uint64_t minv) noexcept
+    {
+        // Each step clears the low limb of t by adding a multiple of m, the carries out of the top limbs being
+        // folded one step later rather than propagated every time
+        uint64_t extra = 0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            const uint64_t carry = addmul_1(t + i, m, n, t[i] * minv);
+            t[i + n] = add_carry(t[i + n], carry, extra);
+        }
+        if(extra || cmp(t + n, n, m, n) >= 0)
+            sub_n(r, t + n, m, n);
+        else
+            copy(r, t + n, n);
+    }
+
+    // Size of the scratch space needed by barrett_reduce
+    constexpr size_t barrett_scratch(size_t k) noexcept
+    {
+        return 4 * k + 5;
+    }
+
+    // r[0..k) = x[0..2k) modulo m[0..k), with m[k-1] != 0 and mu[0..k+2) = floor(2^(128k) / m)
+    // (Barrett reduction, Handbook of Applied Cryptography 14.42)
+    constexpr void barrett_reduce(uint64_t* r, const uint64_t* x, const uint64_t* m, const uint64_t* mu, size_t k,
+                                  uint64_t* scratch) noexcept
+    {
+        // Estimate of the quotient, at most 2 below the actual one
+        uint64_t* q = scratch;
+        mul(q, x + k - 1, k + 1, mu, k + 2);
+        const uint64_t* q3 = q + k + 1;
+
+        // Only the k + 1 low limbs of x - q3 m are needed since the result is below 3m
+        uint64_t* t = scratch + 2 * k + 3;
+        uint64_t* u = t + k + 1;
+        mul_low(t, q3, k + 1, m, k, k + 1);
+        sub_n(u, x, t, k + 1);
+        while(u[k] != 0 || cmp(u, k, m, k) >= 0)
+            sub(u, u, k + 1, m, k);
+        copy(r, u, k);
+    }
+
+
+    // Constant-time kernels: no branch and no memory access depends on the values, only on the sizes
+#ifdef UTILITIES_BIG_INT_VALUE_BARRIER
+    inline uint64_t opaque(uint64_t x) noexcept
+    {
+        __asm__("" : "+r"(x));
+        return x;
+    }
+#endif
+
+    // All ones when c is 1, zero when c is 0
+    constexpr uint64_t ct_mask(uint64_t c) noexcept
+    {
+#ifdef UTILITIES_BIG_INT_VALUE_BARRIER
+        if(!__builtin_is_constant_evaluated())
+            c = opaque(c);
+#endif
+        return uint64_t(0) - c;
+    }
+
+    // 1 when x is zero, 0 otherwise
+    constexpr uint64_t ct_is_zero(uint64_t x) noexcept
+    {
+        return ((x | (uint64_t(0) - x)) >> 63) ^ 1;
+    }
+
+    // r[0..n) = a[0..n) where mask is all ones, b[0..n) where it is zero. r may be equal to a or b
+    constexpr void ct_select(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n, uint64_t mask) noexcept
+    {
+        for(size_t i = 0; i < n; ++i)
+            r[i] = b[i] ^ (mask & (a[i] ^ b[i]));
+    }
+
+    // Swaps a[0..n) and b[0..n) when mask is all ones
+    constexpr void ct_swap(uint64_t* a, uint64_t* b, size_t n, uint64_t mask) noexcept
+    {
+        for(size_t i = 0; i < n; ++i)
+        {
+            const uint64_t t = mask & (a[i] ^ b[i]);
+            a[i] ^= t;
+            b[i] ^= t;
+        }
+    }
+
+    // 1 when a[0..n) == b[0..n), 0 otherwise
+    constexpr uint64_t ct_equal(const uint64_t* a, const uint64_t* b, size_t n) noexcept
+    {
+        uint64_t diff = 0;
+        for(size_t i = 0; i < n; ++i)
+            diff |= a[i] ^ b[i];
+        return ct_is_zero(diff);
+    }
+
+    // 1 when a[0..n) < b[0..n), 0 otherwise, read from the borrow out of a - b
+    constexpr uint64_t ct_less(const uint64_t* a, const uint64_t* b, size_t n) noexcept
+    {
+        uint64_t borrow = 0;
+        for(size_t i = 0; i < n; ++i)
+            sub_borrow(a[i], b[i], borrow);
+        return borrow;
+    }
+
+    // redc whose final subtraction is always computed, the reduced value being selected with a mask
+    constexpr void ct_redc(uint64_t* r, uint64_t* t, const uint64_t* m, size_t n, uint64_t minv) noexcept
+    {
+        uint64_t extra = 0;
+        for(size_t i = 0; i < n; ++i)
+        {
+            const uint64_t carry = addmul_1(t + i, m, n, t[i] * minv);
+            t[i + n] = add_carry(t[i + n], carry, extra);
+        }
+        // t is kept only when it is below m: no extra limb and a borrow out of t - m
+        const uint64_t borrow = sub_n(r, t + n, m, n);
+        ct_select(r, t + n, r, n, ct_mask(borrow & (extra ^ 1)));
+    }
+
+    // Width of the fixed windows of the constant-time exponentiation by an exponent of the given number of bits.
+    // The table holds every power below 2^w and is scanned whole for each window, hence narrower windows than
+    // the sliding ones
+    constexpr size_t ct_window_size(size_t bits) noexcept
+    {
+        return bits > 306 ? 5 : bits > 89 ? 4 : bits > 22 ? 3 : 1;
+    }
+
+    // Bits [i, i + w) of e[0..ne), w < 64
+    constexpr uint64_t bits_at(const uint64_t* e, size_t ne, size_t i, size_t w) noexcept
+    {
+        const size_t limb = i / 64, offset = i % 64;
+        uint64_t x = e[limb] >> offset;
+        if(offset + w > 64 && limb + 1 < ne)
+            x |= e[limb + 1] << (64 - offset);
+        return x & ((uint64_t(1) << w) - 1);
+    }
+
+
+    constexpr size_t karatsuba_threshold = UTILITIES_BIG_INT_KARATSUBA_THRESHOLD;
+    constexpr size_t toom3_threshold = UTILITIES_BIG_INT_TOOM3_THRESHOLD;
+    constexpr size_t ntt_threshold = UTILITIES_BIG_INT_NTT_THRESHOLD;
+    constexpr size_t sqr_karatsuba_threshold = UTILITIES_BIG_INT_SQR_KARATSUBA_THRESHOLD;
+    constexpr size_t div_dc_threshold = UTILITIES_BIG_INT_DIV_DC_THRESHOLD;
+    constexpr size_t conversion_threshold = UTILITIES_BIG_INT_CONVERSION_THRESHOLD;
+    static_assert(div_dc_threshold >= 4, "the recursive division needs divisors of at least 2 limbs");
+    static_assert(conversion_threshold >= 2, "the conversions need at least one level of powers below the threshold");
+    static_assert(karatsuba_threshold >= 4 && toom3_threshold >= 16 && ntt_threshold >= 16,
+                  "multiplication thresholds are too small");
+    static_assert(sqr_karatsuba_threshold >= karatsuba_threshold, "squares use the scratch space of the products");
+
+    constexpr size_t ceil_log2(size_t n) noexcept
+    {
+        size_t l = 0;
+        while((size_t(1) << l) < n)
+            ++l;
+        return l;
+    }
+
+    // Limbs of scratch space needed by mul_ntt for operands of na and nb limbs: the three residues of the product,
+    // the transform of b and the table of the roots of unity, each as long as the transform
+    constexpr size_t ntt_scratch(size_t na, size_t nb) noexcept
+    {
+        return 5 * (size_t(1) << ceil_log2(na + nb - 1));
+    }
+
+    // Limbs of scratch space needed by mul_n and mullo_n on n limbs operands. A closed-form bound that dominates
+    // the space used by each recursion level plus the one of its sub-products
+    constexpr size_t mul_scratch(size_t n) noexcept
+    {
+        if(n < karatsuba_threshold)
+            return 0;
+        const size_t recursive = 10 * n + 16 * ceil_log2(n) + 64;
+        return n < ntt_threshold ? recursive : std::max(recursive, 2 * n + ntt_scratch(n, n));
+    }
+
+    constexpr void mul_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n, uint64_t* scratch) noexcept;
+    constexpr void sqr_n(uint64_t* r, const uint64_t* a, size_t n, uint64_t* scratch) noexcept;
+
+    // Karatsuba: with x = 2^(64k), a = a1 x + a0 and b = b1 x + b0,
+    // a b = a1 b1 x^2 + (a0 b0 + a1 b1 + (a0 - a1)(b1 - b0)) x + a0 b0
+    constexpr void mul_karatsuba(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n, uint64_t* scratch) noexcept
+    {
+        const size_t k = n - n / 2;
+        const size_t h = n / 2;
+
+        uint64_t* da = scratch;
+        uint64_t* db = scratch + k;
+        uint64_t* t = scratch + 2 * k;
+        uint64_t* m = scratch + 4 * k;
+
+        const bool a_neg = sub_abs(da, a, k, a + k, h);
+        const bool b_neg = sub_abs(db, b, k, b + k, h);
+
+        mul_n(r, a, b, k, scratch + 2 * k);
+        mul_n(r + 2 * k, a + k, b + k, h, scratch + 2 * k);
+        mul_n(t, da, db, k, scratch + 4 * k);
+
+        // (a0 - a1)(b1 - b0) = -(a0 - a1)(b0 - b1), the middle term cannot be negative
+        m[2 * k] = add(m, r, 2 * k, r + 2 * k, 2 * h);
+        if(a_neg == b_neg)
+            sub(m, m, 2 * k + 1, t, 2 * k);
+        else
+            add(m, m, 2 * k + 1, t, 2 * k);
+
+        add(r + k, r + k, 2 * n - k, m, std::min(2 * k + 1, 2 * n - k));
+    }
+
+    // Karatsuba square, with the same layout: a^2 = a1^2 x^2 + (a0^2 + a1^2 - (a0 - a1)^2) x + a0^2
+    constexpr void sqr_karatsuba(uint64_t* r, const uint64_t* a, size_t n, uint64_t* scratch) noexcept
+    {
+        const size_t k = n - n / 2;
+        const size_t h = n / 2;
+
+        uint64_t* da = scratch;
+        uint64_t* t = scratch + 2 * k;
+        uint64_t* m = scratch + 4 * k;
+
+        sub_abs(da, a, k, a + k, h);
+
+        sqr_n(r, a, k, scratch + 2 * k);
+        sqr_n(r + 2 * k, a + k, h, scratch + 2 * k);
+        sqr_n(t, da, k, scratch + 4 * k);
+
+        m[2 * k] = add(m, r, 2 * k, r + 2 * k, 2 * h);
+        sub(m, m, 2 * k + 1, t, 2 * k);
+
+        add(r + k, r + k, 2 * n - k, m, std::min(2 * k + 1, 2 * n - k));
+    }
+
+    // Toom-3: a and b are evaluated as polynomials in x = 2^(64k) at 0, 1, -1, 2 and infinity, the five products
+    // giving back the coefficients c0..c4 of the product polynomial. For a square (a == b) the five products are
+    // squares
+    constexpr void mul_toom3(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n, uint64_t* scratch) noexcept
+    {
+        const size_t k = (n + 2) / 3;
+        const size_t s = n - 2 * k;
+        const size_t l = 2 * k + 2;
+
+        uint64_t* ea = scratch;
+        uint64_t* eb = scratch + k + 1;
+        uint64_t* w1 = scratch + 2 * k + 2;
+        uint64_t* wm1 = w1 + l;
+        uint64_t* w2 = wm1 + l;
+        uint64_t* next = w2 + l;
+
+        const bool square = a == b;
+        const auto product = [square, next](uint64_t* p, const uint64_t* x, const uint64_t* y, size_t len) {
+            if(square)
+                sqr_n(p, x, len, next);
+            else
+                mul_n(p, x, y, len, next);
+        };
+
+        // Evaluation at 0 and infinity, straight into place
+        product(r, a, b, k);
+        product(r + 4 * k, a + 2 * k, b + 2 * k, s);
+        const uint64_t* w0 = r;
+        const uint64_t* winf = r + 4 * k;
+
+        // Evaluation at 1
+        ea[k] = add(ea, a, k, a + 2 * k, s);
+        ea[k] += add_n(ea, ea, a + k, k);
+        eb[k] = add(eb, b, k, b + 2 * k, s);
+        eb[k] += add_n(eb, eb, b + k, k);
+        product(w1, ea, eb, k + 1);
+
+        // Evaluation at -1
+        ea[k] = add(ea, a, k, a + 2 * k, s);
+        const bool a_neg = sub_abs(ea, ea, k + 1, a + k, k);
+        eb[k] = add(eb, b, k, b + 2 * k, s);
+        const bool b_neg = sub_abs(eb, eb, k + 1, b + k, k);
+        product(wm1, ea, eb, k + 1);
+        if(a_neg != b_neg)
+            neg(wm1, wm1, l);
+
+        // Evaluation at 2, as (2 a2 + a1) 2 + a0
+        copy(ea, a + 2 * k, s);
+        zero(ea + s, k + 1 - s);
+        lshift(ea, ea, k + 1, 1);
+        add(ea, ea, k + 1, a + k, k);
+        lshift(ea, ea, k + 1, 1);
+        add(ea, ea, k + 1, a, k);
+        copy(eb, b + 2 * k, s);
+        zero(eb + s, k + 1 - s);
+        lshift(eb, eb, k + 1, 1);
+        add(eb, eb, k + 1, b + k, k);
+        lshift(eb, eb, k + 1, 1);
+        add(eb, eb, k + 1, b, k);
+        product(w2, ea, eb, k + 1);
+
+        // Interpolation, modulo 2^(64l) so that the transient negative values are harmless:
+        // c2 = (w1 + wm1) / 2 - c0 - c4, c1 + c3 = (w1 - wm1) / 2, c1 + 4 c3 = (w2 - c0 - 4 c2 - 16 c4) / 2
+        uint64_t* temp = scratch;
+        add_n(wm1, w1, wm1, l);
+        rshift(wm1, wm1, l, 1);
+        sub_n(w1, w1, wm1, l);
+        sub(wm1, wm1, l, w0, 2 * k);
+        sub(wm1, wm1, l, winf, 2 * s);
+        sub(w2, w2, l, w0, 2 * k);
+        lshift(temp, wm1, l, 2);
+        sub_n(w2, w2, temp, l);
+        temp[2 * s] = lshift(temp, winf, 2 * s, 4);
+        sub(w2, w2, l, temp, 2 * s + 1);
+        rshift(w2, w2, l, 1);
+        sub_n(w2, w2, w1, l);
+        divexact_by3(w2, w2, l);
+        sub_n(w1, w1, w2, l);
+
+        // Recomposition: c1 in w1, c2 in wm1, c3 in w2, all non-negative and fitting in the result once shifted
+        zero(r + 2 * k, 2 * k);
+        add(r + k, r + k, 2 * n - k, w1, std::min(l, 2 * n - k));
+        add(r + 2 * k, r + 2 * k, 2 * n - 2 * k, wm1, std::min(l, 2 * n - 2 * k));
+        add(r + 3 * k, r + 3 * k, 2 * n - 3 * k, w2, std::min(l, 2 * n - 3 * k));
+    }
+
+    // Number-theoretic transform multiplication: the limbs are the coefficients of two polynomials whose product is
+    // computed modulo three primes p = c 2^k + 1 by transforms of a power of two length, then rebuilt with the Chinese
+    // remainder theorem. Every coefficient of the product being below n 2^128 < p0 p1 p2, nothing is lost.
+    // The residues are kept in Montgomery form (x 2^64 mod p), the primes being below 2^62 so that no reduction
+    // ever overflows, and within a factor 2 of each other so that a residue modulo one is reduced modulo another
+    // by a single subtraction
+    struct ntt_prime
+    {
+        uint64_t p;
+        uint64_t inv;   // p^-1 mod 2^64
+        uint64_t r2;    // 2^128 mod p, to enter the Montgomery form
+        uint64_t root;  // primitive root modulo p
+    };
+
+    constexpr ntt_prime make_ntt_prime(uint64_t p, uint64_t root) noexcept
+    {
+        // Newton iteration, each step doubling the number of correct low bits
+        uint64_t inv = p;
+        for(int i = 0; i < 5; ++i)
+            inv *= 2 - p * inv;
+        uint64_t r2 = 1;
+        for(int i = 0; i < 128; ++i)
+            r2 = r2 >= p - r2 ? r2 - (p - r2) : 2 * r2;
+        return {p, inv, r2, root};
+    }
+
+    // 29 2^57 + 1, 69 2^55 + 1 and 163 2^54 + 1, allowing transforms of up to 2^54 coefficients
+    constexpr ntt_prime ntt_primes[3] = {make_ntt_prime(0x3A00000000000001, 3),
+                                         make_ntt_prime(0x2280000000000001, 5),
+                                         make_ntt_prime(0x28C0000000000001, 3)};
+
+    // a b 2^-64 mod p, for any a b < p 2^64. The result is below p
+    constexpr uint64_t ntt_mul(uint64_t a, uint64_t b, const ntt_prime& q) noexcept
+    {
+        uint64_t hi = 0, mhi = 0;
+        const uint64_t lo = mul_wide(a, b, hi);
+        mul_wide(lo * q.inv, q.p, mhi);
+        return hi < mhi ? hi - mhi + q.p : hi - mhi;
+    }
+
+    constexpr uint64_t ntt_add(uint64_t a, uint64_t b, const ntt_prime& q) noexcept
+    {
+        const uint64_t s = a + b;
+        return s >= q.p ? s - q.p : s;
+    }
+
+    constexpr uint64_t ntt_sub(uint64_t a, uint64_t b, const ntt_prime& q) noexcept
+    {
+        return a < b ? a - b + q.p : a - b;
+    }
+
+    // x^e mod p, x and the result being in Montgomery form
+    constexpr uint64_t ntt_pow(uint64_t x, uint64_t e, const ntt_prime& q) noexcept
+    {
+        uint64_t r = ntt_mul(1, q.r2, q);
+        for(; e != 0; e >>= 1)
+        {
+            if(e & 1)
+                r = ntt_mul(r, x, q);
+            x = ntt_mul(x, x, q);
+        }
+        return r;
+    }
+
+    // table[m + j] = w^j for every power of two m below l and j below m, w being a primitive 2m-th root of unity
+    constexpr void ntt_roots(uint64_t* table, size_t l, const ntt_prime& q) noexcept
+    {
+        const uint64_t w = ntt_pow(ntt_mul(q.root, q.r2, q), (q.p - 1) / l, q);
+        const size_t h = l / 2;
+        table[h] = ntt_mul(1, q.r2, q);
+        for(size_t j = 1; j < h; ++j)
+            table[h + j] = ntt_mul(table[h + j - 1], w, q);
+        for(size_t m = h / 2; m > 0; m /= 2)
+            for(size_t j = 0; j < m; ++j)
+                table[m + j] = table[2 * m + 2 * j];
+    }
+
+    // Decimation in frequency, x[0..l) going from natural to bit-reversed order
+    constexpr void ntt_forward(uint64_t* x, size_t l, const uint64_t* table, const ntt_prime& q) noexcept
+    {
+        for(size_t m = l / 2; m > 0; m /= 2)
+            for(size_t s = 0; s < l; s += 2 * m)
+                for(size_t j = 0; j < m; ++j)
+                {
+                    const uint64_t u = x[s + j], v = x[s + j + m];
+                    x[s + j] = ntt_add(u, v, q);
+                    x[s + j + m] = ntt_mul(ntt_sub(u, v, q), table[m + j], q);
+                }
+    }
+
+    // Decimation in time with the inverse roots, x[0..l) going from bit-reversed to natural order, scaled by l.
+    // w^-j = -w^(m - j) for a primitive 2m-th root w, so the same table serves
+    constexpr void ntt_inverse(uint64_t* x, size_t l, const uint64_t* table, const ntt_prime& q) noexcept
+    {
+        for(size_t m = 1; m < l; m *= 2)
+            for(size_t s = 0; s < l; s += 2 * m)
+            {
+                const uint64_t u = x[s], v = x[s + m];
+                x[s] = ntt_add(u, v, q);
+                x[s + m] = ntt_sub(u, v, q);
+                for(size_t j = 1; j < m; ++j)
+                {
+                    const uint64_t uj = x[s + j], t = ntt_mul(x[s + j + m], table[2 * m - j], q);
+                    x[s + j] = ntt_sub(uj, t, q);
+                    x[s + j + m] = ntt_add(uj, t, q);
+                }
+            }
+    }
+
+    // r[0..na+nb) = a[0..na) * b[0..nb), r must not overlap a, b or scratch which holds ntt_scratch(na, nb) limbs.
+    // A square (a == b) is transformed once
+    constexpr void mul_ntt(uint64_t* r, const uint64_t* a, size_t na, const uint64_t* b, size_t nb,
+                           uint64_t* scratch) noexcept
+    {
+        const size_t n = na + nb - 1;
+        const size_t l = size_t(1) << ceil_log2(n);
+        uint64_t* fb = scratch + 3 * l;
+        uint64_t* table = fb + l;
+        const bool square = a == b && na == nb;
+
+        for(size_t i = 0; i < 3; ++i)
+        {
+            const ntt_prime& q = ntt_primes[i];
+            uint64_t* fa = scratch + i * l;
+            ntt_roots(table, l, q);
+
+            for(size_t j = 0; j < na; ++j)
+                fa[j] = ntt_mul(a[j], q.r2, q);
+            zero(fa + na, l - na);
+            ntt_forward(fa, l, table, q);
+            if(square)
+                for(size_t j = 0; j < l; ++j)
+                    fa[j] = ntt_mul(fa[j], fa[j], q);
+            else
+            {
+                for(size_t j = 0; j < nb; ++j)
+                    fb[j] = ntt_mul(b[j], q.r2, q);
+                zero(fb + nb, l - nb);
+                ntt_forward(fb, l, table, q);
+                for(size_t j = 0; j < l; ++j)
+                    fa[j] = ntt_mul(fa[j], fb[j], q);
+            }
+            ntt_inverse(fa, l, table, q);
+
+            // Leaves the Montgomery form and divides by l at once, l^-1 being p - (p - 1) / l
+            const uint64_t scale = q.p - (q.p - 1) / l;
+            for(size_t j = 0; j < n; ++j)
+                fa[j] = ntt_mul(fa[j], scale, q);
+        }
+
+        // Garner: x = v0 + v1 p0 + v2 p0 p1 with v0 = x mod p0, v1 = (x - v0) / p0 mod p1 and
+        // v2 = (x - v0 - v1 p0) / (p0 p1) mod p2. The constants are in Montgomery form so that the products come out
+        // plain, the inverses by Fermat's little theorem
+        const ntt_prime& q0 = ntt_primes[0];
+        const ntt_prime& q1 = ntt_primes[1];
+        const ntt_prime& q2 = ntt_primes[2];
+        const uint64_t inv01 = ntt_pow(ntt_mul(q0.p, q1.r2, q1), q1.p - 2, q1);
+        const uint64_t p0_mod_p2 = ntt_mul(q0.p, q2.r2, q2);
+        const uint64_t inv012 = ntt_pow(ntt_mul(p0_mod_p2, ntt_mul(q1.p, q2.r2, q2), q2), q2.p - 2, q2);
+        uint64_t p01[2] = {};
+        p01[0] = mul_wide(q0.p, q1.p, p01[1]);
+
+        uint64_t acc[4] = {};
+        for(size_t j = 0; j < n; ++j)
+        {
+            const uint64_t v0 = scratch[j];
+            const uint64_t v0_mod_p1 = v0 >= q1.p ? v0 - q1.p : v0;
+            const uint64_t v0_mod_p2 = v0 >= q2.p ? v0 - q2.p : v0;
+            const uint64_t v1 = ntt_mul(ntt_sub(scratch[l + j], v0_mod_p1, q1), inv01, q1);
+            const uint64_t t = ntt_sub(ntt_sub(scratch[2 * l + j], v0_mod_p2, q2), ntt_mul(v1, p0_mod_p2, q2), q2);
+            const uint64_t v2 = ntt_mul(t, inv012, q2);
+
+            uint64_t x[3] = {};
+            x[2] = mul_1(x, p01, 2, v2);
+            add_1(x + 1, x + 1, 2, addmul_1(x, &q0.p, 1, v1));
+            add_1(x, x, 3, v0);
+            acc[3] += add_n(acc, acc, x, 3);
+            r[j] = acc[0];
+            acc[0] = acc[1];
+            acc[1] = acc[2];
+            acc[2] = acc[3];
+            acc[3] = 0;
+        }
+        r[n] = acc[0];
+    }
+
+    // Whether a product of n limbs operands goes through the transform. Its cost only grows at each power of two
+    // whereas the one of Toom-3 grows like n^1.47, so past the threshold (where both cost the same for a transform
+    // filled up) the transform is taken once the square of its length over the number of coefficients is below
+    // n / threshold
+    constexpr bool use_ntt(size_t n) noexcept
+    {
+        const double waste = double(size_t(1) << ceil_log2(2 * n - 1)) / double(2 * n);
+        return n >= ntt_threshold && waste * waste * ntt_threshold < n;
+    }
+
+    // r[0..2n) = a[0..n) * b[0..n), r must not overlap a, b or scratch which holds mul_scratch(n) limbs
+    constexpr void mul_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n, uint64_t* scratch) noexcept
+    {
+        if(n < karatsuba_threshold)
+            mul(r, a, n, b, n);
+        else if(n < toom3_threshold)
+            mul_karatsuba(r, a, b, n, scratch);
+        else if(!use_ntt(n))
+            mul_toom3(r, a, b, n, scratch);
+        else
+            mul_ntt(r, a, n, b, n, scratch);
+    }
+
+    // r[0..n) = the n low limbs of a[0..n) * b[0..n): one full product of the low halves and two recursive
+    // low products for the cross terms. The schoolbook low product already saves half of the work, so it is kept
+    // up to twice the Karatsuba threshold. A transform costs the same whether the high half is needed or not, so the
+    // full product is taken when it goes through the NTT
+    constexpr void mullo_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n, uint64_t* scratch) noexcept
+    {
+        if(n < 2 * karatsuba_threshold)
+        {
+            mul_low(r, a, n, b, n, n);
+            return;
+        }
+        if(use_ntt(n))
+        {
+            mul_ntt(scratch, a, n, b, n, scratch + 2 * n);
+            copy(r, scratch, n);
+            return;
+        }
+
+        const size_t k = n - n / 2;
+        const size_t h = n / 2;
+
+        mul_n(scratch, a, b, k, scratch + 2 * k);
+        copy(r, scratch, n);
+        mullo_n(scratch, a + k, b, h, scratch + h);
+        add_n(r + k, r + k, scratch, h);
+        mullo_n(scratch, a, b + k, h, scratch + h);
+        add_n(r + k, r + k, scratch, h);
+    }
+
+    // r[0..2n) = a[0..n)^2, with the same contract as mul_n
+    constexpr void sqr_n(uint64_t* r, const uint64_t* a, size_t n, uint64_t* scratch) noexcept
+    {
+        if(n < sqr_karatsuba_threshold)
+            sqr(r, a, n);
+        else if(n < toom3_threshold)
+            sqr_karatsuba(r, a, n, scratch);
+        else if(!use_ntt(n))
+            mul_toom3(r, a, a, n, scratch);
+        else
+            mul_ntt(r, a, n, a, n, scratch);
+    }
+
+    // r[0..n) = the n low limbs of a[0..n)^2: the square of the low half plus twice the low product of the halves
+    constexpr void sqrlo_n(uint64_t* r, const uint64_t* a, size_t n, uint64_t* scratch) noexcept
+    {
+        if(n < 2 * sqr_karatsuba_threshold)
+        {
+            sqr_low(r, a, n, n);
+            return;
+        }
+        if(use_ntt(n))
+        {
+            mul_ntt(scratch, a, n, a, n, scratch + 2 * n);
+            copy(r, scratch, n);
+            return;
+        }
+
+        const size_t k = n - n / 2;
+        const size_t h = n / 2;
+
+        sqr_n(scratch, a, k, scratch + 2 * k);
+        copy(r, scratch, n);
+        mullo_n(scratch, a + k, a, h, scratch + h);
+        lshift(scratch, scratch, h, 1);
+        add_n(r + k, r + k, scratch, h);
+    }
+
+    // r[0..NR) = the NR low limbs of a[0..NA)^2 with NR <= 2 NA, the algorithm being chosen at compile time
+    template<size_t NA, size_t NR>
+    constexpr void sqr_fixed(uint64_t* r, const uint64_t* a) noexcept
+    {
+        if constexpr(NA < (NR <= NA ? 2 : 1) * sqr_karatsuba_threshold)
+        {
+            if constexpr(NR == 2 * NA)
+                sqr(r, a, NA);
+            else
+                sqr_low(r, a, NA, NR);
+        }
+        else
+        {
+            uint64_t product[NR <= NA ? NA : 2 * NA] = {}, scratch[mul_scratch(NA)] = {};
+            if constexpr(NR <= NA)
+                sqrlo_n(product, a, NA, scratch);
+            else
+                sqr_n(product, a, NA, scratch);
+            copy(r, product, NR);
+        }
+    }
+
+    // r[0..NR) = the NR low limbs of a[0..NA) * b[0..NB), the algorithm being chosen at compile time from the sizes
+    template<size_t NA, size_t NB, size_t NR>
+    constexpr void mul_fixed(uint64_t* r, const uint64_t* a, const uint64_t* b) noexcept
+    {
+        if constexpr(NA == NB && NR <= 2 * NA)
+            if(a == b)
+            {
+                sqr_fixed<NA, NR>(r, a);
+                return;
+            }
+
+        if constexpr(std::min(NA, NB) < (NR <= std::max(NA, NB) ? 2 : 1) * karatsuba_threshold)
+            mul_low(r, a, NA, b, NB, NR);
+        else
+        {
+            // The shorter operand is zero-extended so that the balanced kernels apply
+            constexpr size_t n = std::max(NA, NB);
+            uint64_t x[n] = {}, y[n] = {}, product[NR <= n ? n : 2 * n] = {}, scratch[mul_scratch(n)] = {};
+            copy(x, a, NA);
+            copy(y, b, NB);
+            if constexpr(NR <= n)
+                mullo_n(product, x, y, n, scratch);
+            else
+                mul_n(product, x, y, n, scratch);
+            copy(r, product, NR);
+        }
+    }
+    // Size of the scratch space needed by mul_any for a shorter operand of n limbs
+    constexpr size_t mul_any_scratch(size_t n) noexcept
+    {
+        return 8 * n + mul_scratch(n);
+    }
+
+    // r[0..na+nb) = a[0..na) * b[0..nb) for any sizes, the longer operand being cut in blocks as long as the shorter
+    // one so that the balanced kernels apply. r must not overlap a or b
+    constexpr void mul_any(uint64_t* r, const uint64_t* a, size_t na, const uint64_t* b, size_t nb,
+                           uint64_t* scratch) noexcept
+    {
+        if(na < nb)
+        {
+            mul_any(r, b, nb, a, na, scratch);
+            return;
+        }
+        if(nb < karatsuba_threshold)
+        {
+            mul(r, a, na, b, nb);
+            return;
+        }
+
+        uint64_t* product = scratch;
+        for(size_t i = 0; i < na; i += nb)
+        {
+            const size_t len = std::min(nb, na - i);
+            if(len == nb)
+                mul_n(product, a + i, b, nb, product + 2 * nb);
+            else
+                mul_any(product, b, nb, a + i, len, product + 2 * nb);
+            // The limbs of r above i + nb are still untouched
+            if(i == 0)
+                copy(r, product, nb + len);
+            else
+                add_1(r + i + nb, product + nb, len, add_n(r + i, r + i, product, nb));
+        }
+    }
+
+    constexpr void div_2n_1n(uint64_t* q, uint64_t* u, const uint64_t* d, size_t n, uint64_t* scratch) noexcept;
+
+    // q[0..h) = u[0..3h) / d[0..2h) and u[0..2h) = the remainder, with d normalized and u[h..3h) < d. The quotient
+    // is estimated by dividing by the high half of d, then corrected with the low half. u[2h..3h) is clobbered
+    constexpr void div_3h_2h(uint64_t* q, uint64_t* u, const uint64_t* d, size_t h, uint64_t* scratch) noexcept
+    {
+        uint64_t top = 0;
+        if(cmp(u + 2*h, h, d + h, h) < 0)
+            div_2n_1n(q, u + h, d + h, h, scratch);
+        else
+        {
+            // The high halves are equal, the estimate is clamped to the largest value and the partial remainder
+            // u[h..3h) - q d[h..2h) reduces to u[h..2h) + d[h..2h)
+            for(size_t i = 0; i < h; ++i)
+                q[i] = ~uint64_t(0);
+            top = add_n(u + h, u + h, d + h, h);
+        }
+
+        uint64_t* product = scratch;
+        mul_n(product, q, d, h, product + 2 * h);
+        top -= sub_n(u, u, product, 2 * h);
+        // At most two corrections, the remainder being negative until then
+        while(top != 0)
+        {
+            sub_1(q, q, h, 1);
+            top += add_n(u, u, d, 2 * h);
+        }
+    }
+
+    // q[0..n) = u[0..2n) / d[0..n) and u[0..n) = the remainder, with d normalized and u[n..2n) < d. Recursive
+    // division from Burnikel and Ziegler, "Fast recursive division", in O(M(n) log n). u[n..2n) is clobbered
+    constexpr void div_2n_1n(uint64_t* q, uint64_t* u, const uint64_t* d, size_t n, uint64_t* scratch) noexcept
+    {
+        if(n < div_dc_threshold || n % 2 != 0)
+        {
+            div_basecase(q, u, n, d, n);
+            return;
+        }
+
+        const size_t h = n / 2;
+        div_3h_2h(q + h, u + h, d, h, scratch);
+        div_3h_2h(q, u, d, h, scratch);
+    }
+
+    // Size the divisor of nb limbs is padded to before a recursive division: t 2^j limbs with t below the
+    // threshold, so that every level of the recursion splits evenly
+    constexpr size_t div_dc_size(size_t nb) noexcept
+    {
+        size_t j = 0;
+        while(((nb - 1) >> j) + 1 >= div_dc_threshold)
+            ++j;
+        return (((nb - 1) >> j) + 1) << j;
+    }
+
+    // Size of the scratch space needed by divrem, for any dividend of at most na limbs and divisor of at most nb
+    // limbs. The padded divisor being below 2 nb limbs, the recursive case fits in the second bound
+    constexpr size_t div_scratch(size_t na, size_t nb) noexcept
+    {
+        return nb < div_dc_threshold ? na + 1 + nb : 2 * na + 10 * nb + mul_scratch(2 * nb);
+    }
+
+    // q[0..na-nb] = a[0..na) / b[0..nb) and r[0..nb) = a[0..na) % b[0..nb), with na >= nb and b[nb-1] != 0.
+    // q and r must not overlap a or b. A zero divisor (nb == 0) leaves q and r untouched: the check also keeps
+    // the normalization below from ever seeing a divisor without limbs
+    constexpr void divrem(uint64_t* q, uint64_t* r, const uint64_t* a, size_t na, const uint64_t* b, size_t nb,
+                          uint64_t* scratch) noexcept
+    {
+        if(nb == 0)
+            return;
+        if(nb == 1)
+        {
+            r[0] = divrem_1(q, a, na, b[0]);
+            return;
+        }
+
+        // Both operands are shifted so that the high bit of the divisor is set. For the recursive division they
+        // are also padded with k low zero limbs, and the dividend is cut in blocks as long as the divisor
+        const unsigned s = clz(b[nb-1]);
+        const size_t n = nb < div_dc_threshold ? nb : div_dc_size(nb);
+        const size_t k = n - nb;
+        const size_t nq = na - nb + 1;
+        const size_t blocks = nb < div_dc_threshold ? 1 : (nq + n - 1) / n;
+        const size_t nu = nb < div_dc_threshold ? na + 1 : (blocks + 1) * n;
+        uint64_t* u = scratch;
+        uint64_t* d = u + nu;
+        uint64_t* quotient = d + n;
+        zero(u, nu);
+        zero(d, k);
+        if(s == 0)
+        {
+            copy(u + k, a, na);
+            copy(d + k, b, nb);
+        }
+        else
+        {
+            u[k + na] = lshift(u + k, a, na, s);
+            lshift(d + k, b, nb, s);
+        }
+
+        if(nb < div_dc_threshold)
+            div_basecase(q, u, nq, d, nb);
+        else
+        {
+            // The top block only holds the quotient limbs left over by the full ones below it, when they are few
+            // the basecase is cheaper than a whole recursive division on the zero padding
+            const size_t full = blocks - 1;
+            const size_t top = nq - full * n;
+            if(2 * top <= n)
+                div_basecase(q + full * n, u + full * n, top, d, n);
+            else
+            {
+                div_2n_1n(quotient, u + full * n, d, n, quotient + n);
+                copy(q + full * n, quotient, top);
+            }
+            for(size_t i = full; i-- > 0;)
+                div_2n_1n(q + i * n, u + i * n, d, n, quotient + n);
+        }
+
+        if(s == 0)
+            copy(r, u + k, nb);
+        else
+            rshift(r, u + k, nb, s);
+    }
+
+
+    // Digits, case insensitive for the letters, and their values
+    constexpr char digit_char(unsigned d) noexcept
+    {
+        return "0123456789abcdefghijklmnopqrstuvwxyz"[d];
+    }
+
+    // Value of a digit character, 36 for anything else
+    constexpr unsigned digit_value(char c) noexcept
+    {
+        if(c >= '0' && c <= '9')
+            return static_cast<unsigned>(c - '0');
+        if(c >= 'a' && c <= 'z')
+            return static_cast<unsigned>(c - 'a' + 10);
+        if(c >= 'A' && c <= 'Z')
+            return static_cast<unsigned>(c - 'A' + 10);
+        return 36;
+    }
+
+    // Largest power of base fitting in a limb (10^19 for base 10), digits being set to its number of digits
+    constexpr uint64_t chunk_base(unsigned base, size_t& digits) noexcept
+    {
+        // The loop divides by a variable on each step, which is most of the conversion time of a small value
+        if(base == 10)
+        {
+            digits = 19;
+            return 10000000000000000000u;
+        }
+
+        uint64_t power = base;
+        digits = 1;
+        while(power <= ~uint64_t(0) / base)
+        {
+            power *= base;
+            ++digits;
+        }
+        return power;
+    }
+
+    // Powers C^(2^i) of the chunk base C, the divisors of the divide and conquer conversions
+    struct power_table
+    {
+        const uint64_t* power[64] = {};
+        size_t size[64] = {};
+        size_t digits[64] = {};
+        size_t count = 0;
+    };
+
+    // Size of the buffer needed by build_powers
+    constexpr size_t powers_size(size_t n) noexcept
+    {
+        return 2 * n + 68;
+    }
+
+    // Fills table with the powers of at most n limbs spanning less than max_digits digits, stored in buffer.
+    // Returns the end of the part of buffer in use
+    constexpr uint64_t* build_powers(power_table& table, unsigned base, size_t n, size_t max_digits, uint64_t* buffer,
+                                     uint64_t* scratch) noexcept
+    {
+        size_t digits = 0;
+        buffer[0] = chunk_base(base, digits);
+        table.power[0] = buffer;
+        table.size[0] = 1;
+        table.digits[0] = digits;
+        table.count = 1;
+        buffer += 1;
+
+        for(;;)
+        {
+            const size_t i = table.count - 1, s = table.size[i];
+            if(2 * s - 1 > n || 2 * table.digits[i] >= max_digits)
+                break;
+            sqr_n(buffer, table.power[i], s, scratch);
+            const size_t size = significant(buffer, 2 * s);
+            if(size > n)
+                break;
+            table.power[i + 1] = buffer;
+            table.size[i + 1] = size;
+            table.digits[i + 1] = 2 * table.digits[i];
+            ++table.count;
+            buffer += size;
+        }
+        return buffer;
+    }
+
+    // Writes x as exactly count digits, ending just before end
+    constexpr void write_chunk(char* end, uint64_t x, size_t count, unsigned base) noexcept
+    {
+        // A constant divisor lets the compiler turn the divisions into multiplications
+        if(base == 10)
+            for(; count > 0; --count, x /= 10)
+                *--end = static_cast<char>('0' + x % 10);
+        else
+            for(; count > 0; --count, x /= base)
+                *--end = digit_char(static_cast<unsigned>(x % base));
+    }
+
+    // Writes a[0..n) without leading zeros by repeated divisions by the chunk base C = base^chunk_digits, returns
+    // the end of the digits or nullptr when they do not fit. The scratch holds a copy of a then the chunks
+    constexpr char* write_chunks(char* out, char* last, const uint64_t* a, size_t n, uint64_t chunk,
+                                 size_t chunk_digits, unsigned base, uint64_t* scratch) noexcept
+    {
+        // The chunks are collected low first, only the highest one is written without padding
+        uint64_t* t = scratch;
+        uint64_t* chunks = t + n;
+        size_t c = 0;
+        copy(t, a, n);
+        while(n > 0)
+        {
+            chunks[c++] = divrem_1(t, t, n, chunk);
+            n = significant(t, n);
+        }
+        if(c == 0)
+            chunks[c++] = 0;
+
+        size_t top_digits = 1;
+        if(base == 10)
+            for(uint64_t x = chunks[c-1]; x >= 10; x /= 10)
+                ++top_digits;
+        else
+            for(uint64_t x = chunks[c-1]; x >= base; x /= base)
+                ++top_digits;
+        if(static_cast<size_t>(last - out) < top_digits + (c - 1) * chunk_digits)
+            return nullptr;
+        out += top_digits;
+        write_chunk(out, chunks[c-1], top_digits, base);
+        for(size_t j = c - 1; j-- > 0;)
+        {
+            out += chunk_digits;
+            write_chunk(out, chunks[j], chunk_digits, base);
+        }
+        return out;
+    }
+
+    // Writes a[0..n) < C^(2^(i+1)) as exactly 2 table.digits[i] digits, leading zeros included
+    constexpr void write_digits_exact(char* out, const uint64_t* a, size_t n, size_t i, const power_table& table,
+                                      unsigned base, uint64_t* scratch) noexcept
+    {
+        const size_t count = 2 * table.digits[i], chunk_digits = table.digits[0];
+        n = significant(a, n);
+        if(table.size[i] < conversion_threshold)
+        {
+            // Schoolbook conversion, the chunks being peeled off from the low end
+            uint64_t* t = scratch;
+            copy(t, a, n);
+            for(char* end = out + count; end != out; end -= chunk_digits)
+            {
+                const uint64_t x = n > 0 ? divrem_1(t, t, n, table.power[0][0]) : 0;
+                n = significant(t, n);
+                write_chunk(end, x, chunk_digits, base);
+            }
+            return;
+        }
+
+        // Both halves are below C^(2^i)
+        const size_t s = table.size[i];
+        uint64_t* q = scratch;
+        uint64_t* r = q + std::max(n, s) + 1;
+        uint64_t* rest = r + s;
+        zero(q, std::max(n, s) + 1);
+        if(n < s)
+        {
+            copy(r, a, n);
+            zero(r + n, s - n);
+        }
+        else
+            divrem(q, r, a, n, table.power[i], s, rest);
+        write_digits_exact(out, q, n < s ? 1 : n - s + 1, i - 1, table, base, rest);
+        write_digits_exact(out + count / 2, r, s, i - 1, table, base, rest);
+    }
+
+    // Writes a[0..n) < C^(2^(i+1)) without leading zeros from out, returns the end of the digits or nullptr when
+    // they do not fit before last
+    constexpr char* write_digits(char* out, char* last, const uint64_t* a, size_t n, size_t i,
+                                 const power_table& table, unsigned base, uint64_t* scratch) noexcept
+    {
+        n = significant(a, n);
+        while(i > 0 && (n < table.size[i] || (n == table.size[i] && cmp(a, n, table.power[i], n) < 0)))
+            --i;
+
+        if(table.size[i] < conversion_threshold)
+            return write_chunks(out, last, a, n, table.power[0][0], table.digits[0], base, scratch);
+
+        // a >= C^(2^i) here, the remainder takes exactly table.digits[i] digits
+        const size_t s = table.size[i];
+        uint64_t* q = scratch;
+        uint64_t* r = q + n - s + 1;
+        uint64_t* rest = r + s;
+        divrem(q, r, a, n, table.power[i], s, rest);
+        out = write_digits(out, last, q, n - s + 1, i - 1, table, base, rest);
+        if(out == nullptr || static_cast<size_t>(last - out) < table.digits[i])
+            return nullptr;
+        write_digits_exact(out, r, s, i - 1, table, base, rest);
+        return out + table.digits[i];
+    }
+
+    // Size of the scratch space needed by to_chars for values of n limbs. Below the threshold, only a copy of the
+    // value and its chunks, each chunk base being above 2^32
+    constexpr size_t to_chars_scratch(size_t n) noexcept
+    {
+        if(n < conversion_threshold)
+            return 3 * n + 1;
+        return powers_size(n) + 4 * n + 192 + std::max(div_scratch(n, n), mul_scratch(n));
+    }
+
+    // Writes a[0..n) in base 2 to 36 to [first, last), returns the end of the digits or nullptr when they do not fit.
+    // Other bases than the powers of 2 are divided and conquered by the powers C^(2^i) of the chunk base, which makes
+    // the conversion subquadratic once the recursive division kicks in
+    constexpr char* to_chars(char* first, char* last, const uint64_t* a, size_t n, unsigned base,
+                             uint64_t* scratch) noexcept
+    {
+        n = significant(a, n);
+        if(n == 0)
+        {
+            if(first == last)
+                return nullptr;
+            *first = '0';
+            return first + 1;
+        }
+
+        if((base & (base - 1)) == 0)
+        {
+            // Every digit is a fixed group of bits
+            const unsigned bits = 63 - clz(base);
+            const size_t count = (64 * n - clz(a[n-1]) + bits - 1) / bits;
+            if(static_cast<size_t>(last - first) < count)
+                return nullptr;
+            for(size_t j = 0; j < count; ++j)
+            {
+                const size_t position = (count - 1 - j) * bits, limb = position / 64, offset = position % 64;
+                uint64_t x = a[limb] >> offset;
+                if(offset + bits > 64 && limb + 1 < n)
+                    x |= a[limb + 1] << (64 - offset);
+                first[j] = digit_char(static_cast<unsigned>(x & (base - 1)));
+            }
+            return first + count;
+        }
+
+        // Too small to be divided and conquered, the table of powers would only be built for its first entry
+        if(n < conversion_threshold)
+        {
+            size_t chunk_digits = 0;
+            const uint64_t chunk = chunk_base(base, chunk_digits);
+            return write_chunks(first, last, a, n, chunk, chunk_digits, base, scratch);
+        }
+
+        // The powers stop at n limbs, so a is below the next one
+        power_table table;
+        uint64_t* rest = build_powers(table, base, n, ~size_t(0), scratch, scratch + powers_size(n));
+        return write_digits(first, last, a, n, table.count - 1, table, base, rest);
+    }
+
+    // r = value of the count digits at s (all valid), r holding ceil(count / table.digits[0]) limbs.
+    // Returns the number of significant limbs of r
+    constexpr size_t read_digits(uint64_t* r, const char* s, size_t count, const power_table& table, unsigned base,
+                                 uint64_t* scratch) noexcept
+    {
+        const size_t chunk_digits = table.digits[0];
+        size_t i = table.count;
+        while(i > 0 && table.digits[i-1] >= count)
+            --i;
+
+        if(i == 0 || table.size[i-1] < conversion_threshold)
+        {
+            // Schoolbook conversion, r = r C + chunk for every chunk, the first one being the shorter
+            size_t n = 0;
+            for(size_t len = (count - 1) % chunk_digits + 1; count > 0; count -= len, s += len, len = chunk_digits)
+            {
+                uint64_t x = 0;
+                for(size_t j = 0; j < len; ++j)
+                    x = x * base + digit_value(s[j]);
+                if(n == 0)
+                {
+                    r[0] = x;
+                    n = x != 0;
+                    continue;
+                }
+                const uint64_t carry = mul_1(r, r, n, table.power[0][0]) + add_1(r, r, n, x);
+                if(carry != 0)
+                    r[n++] = carry;
+            }
+            return n;
+        }
+
+        // The low part takes exactly table.digits[i-1] digits, r = high C^(2^(i-1)) + low
+        const size_t low_count = table.digits[i-1], high_count = count - low_count;
+        const size_t high_size = (high_count + chunk_digits - 1) / chunk_digits, low_size = low_count / chunk_digits;
+        uint64_t* high = scratch;
+        uint64_t* low = high + high_size;
+        uint64_t* rest = low + low_size;
+        const size_t nh = read_digits(high, s, high_count, table, base, rest);
+        const size_t nl = read_digits(low, s + high_count, low_count, table, base, rest);
+
+        const size_t n = high_size + low_size;
+        zero(r, n);
+        if(nh > 0)
+            mul_any(r, high, nh, table.power[i-1], table.size[i-1], rest);
+        add(r, r, n, low, nl);
+        return significant(r, n);
+    }
+
+    // Size of the scratch space needed by from_chars for values of n limbs
+    constexpr size_t from_chars_scratch(size_t n) noexcept
+    {
+        return powers_size(n) + 2 * n + 128 + std::max(mul_any_scratch(n), mul_scratch(n));
+    }
+
+    // r = value of the count digits at s, all valid in base 2 to 36, r holding n = ceil(count / chunk digits) limbs.
+    // Returns the number of significant limbs of r
+    constexpr size_t from_chars(uint64_t* r, const char* s, size_t count, unsigned base, uint64_t* scratch) noexcept
+    {
+        size_t chunk_digits = 0;
+        chunk_base(base, chunk_digits);
+        const size_t n = (count + chunk_digits - 1) / chunk_digits;
+
+        if((base & (base - 1)) == 0)
+        {
+            const unsigned bits = 63 - clz(base);
+            zero(r, n);
+            for(size_t j = 0; j < count; ++j)
+            {
+                const size_t position = (count - 1 - j) * bits, limb = position / 64, offset = position % 64;
+                const uint64_t x = digit_value(s[j]);
+                r[limb] |= x << offset;
+                if(offset + bits > 64 && limb + 1 < n)
+                    r[limb + 1] |= x >> (64 - offset);
+            }
+            return significant(r, n);
+        }
+
+        power_table table;
+        uint64_t* rest = build_powers(table, base, n, count, scratch, scratch + powers_size(n));
+        return read_digits(r, s, count, table, base, rest);
+    }
+
+    // Width of the sliding window used to exponentiate by an exponent of the given number of bits
+    constexpr size_t window_size(size_t bits) noexcept
+    {
+        return bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : 1;
+    }
+
+    // base^e[0..ne) with left-to-right sliding windows, ctx providing mul, sqr and one on Value.
+    // The odd powers of base up to 2^w - 1 are precomputed, then every window costs one multiplication
+    template<typename Context, typename Value>
+    constexpr Value pow_sliding_window(const Context& ctx, const Value& base, const uint64_t* e, size_t ne) noexcept
+    {
+        ne = significant(e, ne);
+        if(ne == 0)
+            return ctx.one();
+
+        const size_t bits = 64 * ne - clz(e[ne-1]);
+        const size_t w = window_size(bits);
+        const auto bit = [e](size_t i) { return (e[i / 64] >> (i % 64)) & 1; };
+
+        Value table[size_t(1) << 5];
+        table[0] = base;
+        if(w > 1)
+        {
+            const Value square = ctx.sqr(base);
+            for(size_t k = 1; k < (size_t(1) << (w - 1)); ++k)
+                table[k] = ctx.mul(table[k-1], square);
+        }
+
+        // The leading bit is set so the first window only loads its power from the table
+        Value result;
+        bool started = false;
+        for(size_t i = bits; i-- > 0;)
+        {
+            if(!bit(i))
+            {
+                result = ctx.sqr(result);
+                continue;
+            }
+
+            // Longest window [j, i] of at most w bits ending on a set bit
+            size_t j = i + 1 > w ? i + 1 - w : 0;
+            while(!bit(j))
+                ++j;
+            size_t value = 0;
+            for(size_t k = i + 1; k-- > j;)
+            {
+                value = (value << 1) | bit(k);
+                if(started)
+                    result = ctx.sqr(result);
+            }
+            result = started ? ctx.mul(result, table[value >> 1]) : table[value >> 1];
+            started = true;
+            i = j;
+        }
+
+        return result;
+    }
+}
+
+
+template<size_t N>
+class UInt;
+
+template<size_t N>
+class Montgomery;
+
+template<size_t N>
+class Barrett;
+
+template<size_t N>
+class UIntBatch;
+
+template<size_t N>
+class Int;
+
+class BigInt;
+
+// Tag selecting the constant-time version of an operation, whose running time and memory accesses depend on the
+// widths of the operands but never on their values
+struct constant_time_t
+{
+    explicit constexpr constant_time_t() = default;
+};
+inline constexpr constant_time_t constant_time{};
+
+template<size_t N>
+constexpr std::to_chars_result to_chars(char* first, char* last, const UInt<N>& value, int base = 10) noexcept;
+
+template<size_t N>
+constexpr std::from_chars_result from_chars(const char* first, const char* last, UInt<N>& value, int base = 10) noexcept;
+
+
+template<size_t N>
+class UInt
+{
+    template<size_t M>
+    friend class UInt;
+    template<size_t M>
+    friend constexpr UInt<M> operator~(UInt<M> n) noexcept;
+    template<size_t L, size_t M>
+    friend constexpr int compare(const UInt<L>& a, const UInt<M>& b) noexcept;
+    template<size_t M>
+    friend constexpr size_t bit_width(const UInt<M>& a) noexcept;
+    template<size_t M>
+    friend constexpr size_t countr_zero(const UInt<M>& a) noexcept;
+    template<size_t M>
+    friend constexpr size_t popcount(const UInt<M>& a) noexcept;
+    template<size_t M>
+    friend std::ostream& operator<<(std::ostream& out, const UInt<M>& n) noexcept;
+    template<size_t L, size_t M>
+    friend constexpr auto operator*(const UInt<L>& a, const UInt<M>& b) noexcept;
+    template<size_t L, size_t M>
+    friend constexpr UInt<L + M> wide_mul(const UInt<L>& a, const UInt<M>& b) noexcept;
+    template<size_t M>
+    friend constexpr UInt<M> sqr(const UInt<M>& a) noexcept;
+    template<size_t M>
+    friend constexpr UInt<2 * M> wide_sqr(const UInt<M>& a) noexcept;
+    template<size_t K, size_t L, size_t M>
+    friend constexpr UInt<K>& mul_add(UInt<K>& acc, const UInt<L>& a, const UInt<M>& b) noexcept;
+    template<size_t L, size_t M>
+    friend constexpr UInt<L>& mul_add_word(UInt<L>& acc, const UInt<M>& a, uint64_t b) noexcept;
+    template<size_t L, size_t M>
+    friend constexpr auto divmod(const UInt<L>& a, const UInt<M>& b) noexcept;
+    template<size_t M>
+    friend constexpr std::pair<UInt<M>, uint64_t> divmod(const UInt<M>& a, uint64_t b) noexcept;
+    template<size_t M>
+    friend constexpr UInt<M> modinv(const UInt<M>& a, const UInt<M>& m) noexcept;
+    template<size_t M>
+    friend constexpr std::to_chars_result to_chars(char* first, char* last, const UInt<M>& value, int base) noexcept;
+    template<size_t M>
+    friend constexpr std::from_chars_result from_chars(const char* first, const char* last, UInt<M>& value,
+                                                       int base) noexcept;
+    template<size_t L, size_t M>
+    friend constexpr UInt<L> modpow(const UInt<L>& a, const UInt<M>& e, const UInt<L>& m) noexcept;
+    template<size_t M>
+    friend constexpr bool equal(const UInt<M>& a, const UInt<M>& b, constant_time_t) noexcept;
+    template<size_t M>
+    friend constexpr int compare(const UInt<M>& a, const UInt<M>& b, constant_time_t) noexcept;
+    template<size_t M>
+    friend constexpr UInt<M> select(bool c, const UInt<M>& a, const UInt<M>& b, constant_time_t) noexcept;
+    template<size_t M>
+    friend constexpr void cswap(bool c, UInt<M>& a, UInt<M>& b, constant_time_t) noexcept;
+    template<size_t M>
+    friend class Montgomery;
+    template<size_t M>
+    friend class Barrett;
+    template<size_t M>
+    friend class UIntBatch;
+    template<size_t M>
+    friend class Int;
+    friend class BigInt;
+
+    public:
+        // Number of 64 bits limbs used to store the value, least significant first
+        static constexpr size_t limb_count = ceil_div<64>(N);
+
+        // Constructors
+        constexpr UInt() noexcept;
+        constexpr UInt(const uint64_t& ull) noexcept;
+        constexpr UInt(const UInt& a) noexcept = default;
+        template<size_t M>
+        constexpr UInt(const UInt<M>& a) noexcept;
+
+        // Assignment operators
+        template<size_t M>
+        constexpr UInt& operator=(const UInt<M>& a) noexcept;
+
+        // Bit manipulation-assignement operator
+        template<size_t M>
+        constexpr UInt& operator&=(const UInt<M>& a) noexcept;
+        constexpr UInt& operator&=(const uint64_t& a) noexcept;
+        template<size_t M>
+        constexpr UInt& operator|=(const UInt<M>& a) noexcept;
+        constexpr UInt& operator|=(const uint64_t& a) noexcept;
+        template<size_t M>
+        constexpr UInt& operator^=(const UInt<M>& a) noexcept;
+        constexpr UInt& operator^=(const uint64_t& a) noexcept;
+        constexpr UInt& operator<<=(size_t n) noexcept;
+        constexpr UInt& operator>>=(size_t n) noexcept;
+
+        // Arithmetic-assignement operators
+        template<size_t M>
+        constexpr UInt& operator+=(const UInt<M>& a) noexcept;
+        constexpr UInt& operator+=(uint64_t a) noexcept;
+        template<size_t M>
+        constexpr UInt& operator-=(const UInt<M>& a) noexcept;
+        constexpr UInt& operator-=(uint64_t a) noexcept;
+        template<size_t M>
+        constexpr UInt& operator*=(const UInt<M>& a) noexcept;
+        constexpr UInt& operator*=(uint64_t a) noexcept;
+        template<size_t M>
+        constexpr UInt& operator/=(const UInt<M>& a) noexcept;
+        constexpr UInt& operator/=(uint64_t a) noexcept;
+        template<size_t M>
+        constexpr UInt& operator%=(const UInt<M>& a) noexcept;
+        constexpr UInt& operator%=(uint64_t a) noexcept;
+
+
+    private:
+
+        uint64_t data[limb_count] = {};
+
+        void write_hex(std::ostream& out) const noexcept;
+        constexpr void truncate() noexcept;
+};
+
+// Constructors
+template<size_t N>
+constexpr UInt<N>::UInt() noexcept
+{
+    static_assert(N>0, "number of bits must be greater than 0");
+}
+
+template<size_t N>
+constexpr UInt<N>::UInt(const uint64_t& ull) noexcept : UInt ()
+{
+    data[0] = ull;
+    truncate();
+}
+
+template<size_t N>
+template<size_t M>
+constexpr UInt<N>::UInt(const UInt<M>& a) noexcept : UInt()
+{
+    for(size_t i = 0; i < std::min(limb_count, UInt<M>::limb_count); ++i)
+        data[i] = a.data[i];
+    truncate();
+}
+
+
+// Assignment operators
+template<size_t N>
+template<size_t M>
+constexpr UInt<N>& UInt<N>::operator=(const UInt<M>& a) noexcept
+{
+    for(size_t i = 0; i < std::min(limb_count, UInt<M>::limb_count); ++i)
+        data[i] = a.data[i];
+    for(size_t i = std::min(limb_count, UInt<M>::limb_count); i < limb_count; ++i)
+        data[i] = 0;
+    truncate();
+
+    return *this;
+}
+
+
+// ~ operator
+template<size_t N>
+constexpr UInt<N> operator~(UInt<N> n) noexcept
+{
+    for(auto& elem : n.data)
+        elem = ~elem;
+    n.truncate();
+    return n;
+}
+
+
+// &, &= operators
+template<size_t N, size_t M>
+constexpr auto operator&(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    UInt<std::max(N, M)> c = a;
+    return c &= b;
+};
+
+template<size_t N>
+constexpr auto operator&(const UInt<N>& a, const uint64_t& b) noexcept
+{
+    return a & UInt<64>(b);
+};
+
+template<size_t N>
+constexpr auto operator&(const uint64_t& a, const UInt<N>& b) noexcept
+{
+    return UInt<64>(a) & b;
+};
+
+template<size_t N>
+template<size_t M>
+constexpr UInt<N>& UInt<N>::operator&=(const UInt<M>& a) noexcept
+{
+    for(size_t i = 0; i < std::min(limb_count, UInt<M>::limb_count); ++i)
+        data[i] &= a.data[i];
+    for(size_t i = std::min(limb_count, UInt<M>::limb_count); i < limb_count; ++i)
+        data[i] = 0;
+    truncate();
+
+    return *this;
+}
+
+template<size_t N>
+constexpr UInt<N>& UInt<N>::operator&=(const uint64_t& a) noexcept
+{
+    data[0] &= a;
+    for(size_t i = 1; i < limb_count; ++i)
+        data[i] = 0;
+
+    return *this;
+}
+
+
+// |, |= operators
+template<size_t N, size_t M>
+constexpr auto operator|(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    UInt<std::max(N, M)> c = a;
+    return c |= b;
+};
+
+template<size_t N>
+constexpr auto operator|(const UInt<N>& a, const uint64_t& b) noexcept
+{
+    return a | UInt<64>(b);
+};
+
+template<size_t N>
+constexpr auto operator|(const uint64_t& a, const UInt<N>& b) noexcept
+{
+    return UInt<64>(a) | b;
+};
+
+template<size_t N>
+template<size_t M>
+constexpr UInt<N>& UInt<N>::operator|=(const UInt<M>& a) noexcept
+{
+    for(size_t i = 0; i < std::min(limb_count, UInt<M>::limb_count); ++i)
+        data[i] |= a.data[i];
+    truncate();
+
+    return *this;
+}
+
+template<size_t N>
+constexpr UInt<N>& UInt<N>::operator|=(const uint64_t& a) noexcept
+{
+    data[0] |= a;
+    truncate();
+
+    return *this;
+}
+
+
+// ^, ^= operators
+template<size_t N, size_t M>
+constexpr auto operator^(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    UInt<std::max(N, M)> c = a;
+    return c ^= b;
+};
+
+template<size_t N>
+constexpr auto operator^(const UInt<N>& a, const uint64_t& b) noexcept
+{
+    return a ^ UInt<64>(b);
+};
+
+template<size_t N>
+constexpr auto operator^(const uint64_t& a, const UInt<N>& b) noexcept
+{
+    return UInt<64>(a) ^ b;
+};
+
+template<size_t N>
+template<size_t M>
+constexpr UInt<N>& UInt<N>::operator^=(const UInt<M>& a) noexcept
+{
+    for(size_t i = 0; i < std::min(limb_count, UInt<M>::limb_count); ++i)
+        data[i] ^= a.data[i];
+    truncate();
+
+    return *this;
+}
+
+template<size_t N>
+constexpr UInt<N>& UInt<N>::operator^=(const uint64_t& a) noexcept
+{
+    data[0] ^= a;
+    truncate();
+
+    return *this;
+}
+
+
+// <<, <<= operators
+template<size_t N>
+constexpr UInt<N> operator<<(const UInt<N>& a, uint64_t n) noexcept
+{
+    UInt<N> c = a;
+    return c <<= n;
+}
+
+// Whole limbs are moved first, the remaining bits being shifted by the limb kernel
+template<size_t N>
+constexpr UInt<N>& UInt<N>::operator<<=(size_t n) noexcept
+{
+    if(n >= N)
+    {
+        implementation_detail::zero(data, limb_count);
+        return *this;
+    }
+
+    const size_t m = n / 64;
+    const unsigned l = n % 64;
+    for(size_t i = limb_count; i-- > m;)
+        data[i] = data[i-m];
+    implementation_detail::zero(data, m);
+    if(l != 0)
+        implementation_detail::lshift(data + m, data + m, limb_count - m, l);
+    truncate();
+
+    return *this;
+}
+
+
+// >>, >>= operators
+template<size_t N>
+constexpr UInt<N> operator>>(const UInt<N>& a, uint64_t n) noexcept
+{
+    UInt<N> c = a;
+    return c >>= n;
+}
+
+template<size_t N>
+constexpr UInt<N>& UInt<N>::operator>>=(size_t n) noexcept
+{
+    if(n >= N)
+    {
+        implementation_detail::zero(data, limb_count);
+        return *this;
+    }
+
+    const size_t m = n / 64;
+    const unsigned l = n % 64;
+    implementation_detail::copy(data, data + m, limb_count - m);
+    implementation_detail::zero(data + limb_count - m, m);
+    if(l != 0)
+        implementation_detail::rshift(data, data, limb_count - m, l);
+
+    return *this;
+}
+
+
+// Comparison operators
+// -1, 0 or 1 as a is below, equal to or above b
+template<size_t N, size_t M>
+constexpr int compare(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    constexpr size_t na = UInt<N>::limb_count;
+    constexpr size_t nb = UInt<M>::limb_count;
+    if constexpr(na >= nb)
+        return implementation_detail::cmp(a.data, na, b.data, nb);
+    else
+        return -implementation_detail::cmp(b.data, nb, a.data, na);
+}
+
+template<size_t N>
+constexpr int compare(const UInt<N>& a, const uint64_t& b) noexcept
+{
+    return compare(a, UInt<64>(b));
+}
+
+template<size_t N>
+constexpr int compare(const uint64_t& a, const UInt<N>& b) noexcept
+{
+    return compare(UInt<64>(a), b);
+}
+
+template<size_t N, size_t M>
+constexpr bool operator==(const UInt<N>& a, const UInt<M>& b) noexcept { return compare(a, b) == 0; }
+template<size_t N, size_t M>
+constexpr bool operator!=(const UInt<N>& a, const UInt<M>& b) noexcept { return compare(a, b) != 0; }
+template<size_t N, size_t M>
+constexpr bool operator<(const UInt<N>& a, const UInt<M>& b) noexcept { return compare(a, b) < 0; }
+template<size_t N, size_t M>
+constexpr bool operator<=(const UInt<N>& a, const UInt<M>& b) noexcept { return compare(a, b) <= 0; }
+template<size_t N, size_t M>
+constexpr bool operator>(const UInt<N>& a, const UInt<M>& b) noexcept { return compare(a, b) > 0; }
+template<size_t N, size_t M>
+constexpr bool operator>=(const UInt<N>& a, const UInt<M>& b) noexcept { return compare(a, b) >= 0; }
+
+template<size_t N>
+constexpr bool operator==(const UInt<N>& a, const uint64_t& b) noexcept { return compare(a, b) == 0; }
+template<size_t N>
+constexpr bool operator!=(const UInt<N>& a, const uint64_t& b) noexcept { return compare(a, b) != 0; }
+template<size_t N>
+constexpr bool operator<(const UInt<N>& a, const uint64_t& b) noexcept { return compare(a, b) < 0; }
+template<size_t N>
+constexpr bool operator<=(const UInt<N>& a, const uint64_t& b) noexcept { return compare(a, b) <= 0; }
+template<size_t N>
+constexpr bool operator>(const UInt<N>& a, const uint64_t& b) noexcept { return compare(a, b) > 0; }
+template<size_t N>
+constexpr bool operator>=(const UInt<N>& a, const uint64_t& b) noexcept { return compare(a, b) >= 0; }
+
+template<size_t N>
+constexpr bool operator==(const uint64_t& a, const UInt<N>& b) noexcept { return compare(a, b) == 0; }
+template<size_t N>
+constexpr bool operator!=(const uint64_t& a, const UInt<N>& b) noexcept { return compare(a, b) != 0; }
+template<size_t N>
+constexpr bool operator<(const uint64_t& a, const UInt<N>& b) noexcept { return compare(a, b) < 0; }
+template<size_t N>
+constexpr bool operator<=(const uint64_t& a, const UInt<N>& b) noexcept { return compare(a, b) <= 0; }
+template<size_t N>
+constexpr bool operator>(const uint64_t& a, const UInt<N>& b) noexcept { return compare(a, b) > 0; }
+template<size_t N>
+constexpr bool operator>=(const uint64_t& a, const UInt<N>& b) noexcept { return compare(a, b) >= 0; }
+
+#ifdef UTILITIES_BIG_INT_THREE_WAY_COMPARISON
+template<size_t N, size_t M>
+constexpr std::strong_ordering operator<=>(const UInt<N>& a, const UInt<M>& b) noexcept { return compare(a, b) <=> 0; }
+template<size_t N>
+constexpr std::strong_ordering operator<=>(const UInt<N>& a, const uint64_t& b) noexcept { return compare(a, b) <=> 0; }
+#endif
+
+
+// Bit queries
+// Number of bits needed to represent a, 0 for 0
+template<size_t N>
+constexpr size_t bit_width(const UInt<N>& a) noexcept
+{
+    const size_t n = implementation_detail::significant(a.data, UInt<N>::limb_count);
+    return n == 0 ? 0 : 64 * n - implementation_detail::clz(a.data[n-1]);
+}
+
+// Number of zero bits above the most significant set bit, N for 0
+template<size_t N>
+constexpr size_t countl_zero(const UInt<N>& a) noexcept
+{
+    return N - bit_width(a);
+}
+
+// Number of zero bits below the least significant set bit, N for 0
+template<size_t N>
+constexpr size_t countr_zero(const UInt<N>& a) noexcept
+{
+    for(size_t i = 0; i < UInt<N>::limb_count; ++i)
+        if(a.data[i] != 0)
+            return 64 * i + implementation_detail::ctz(a.data[i]);
+    return N;
+}
+
+// Number of set bits
+template<size_t N>
+constexpr size_t popcount(const UInt<N>& a) noexcept
+{
+    size_t count = 0;
+    for(size_t i = 0; i < UInt<N>::limb_count; ++i)
+        count += implementation_detail::popcount(a.data[i]);
+    return count;
+}
+
+
+// +, += operators
+template<size_t N, size_t M>
+constexpr auto operator+(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    UInt<std::max(N, M)> c = a;
+    return c += b;
+}
+
+template<size_t N>
+constexpr auto operator+(const UInt<N>& a, const uint64_t& b) noexcept
+{
+    return a + UInt<64>(b);
+}
+
+template<size_t N>
+constexpr auto operator+(const uint64_t& a, const UInt<N>& b) noexcept
+{
+    return UInt<64>(a) + b;
+}
+
+template<size_t N>
+template<size_t M>
+constexpr UInt<N>& UInt<N>::operator+=(const UInt<M>& a) noexcept
+{
+    implementation_detail::add(data, data, limb_count, a.data, std::min(limb_count, UInt<M>::limb_count));
+    truncate();
+
+    return *this;
+}
+
+template<size_t N>
+constexpr UInt<N>& UInt<N>::operator+=(uint64_t a) noexcept
+{
+    implementation_detail::add_1(data, data, limb_count, a);
+    truncate();
+
+    return *this;
+}
+
+
+// -, -= operators
+template<size_t N, size_t M>
+constexpr auto operator-(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    UInt<std::max(N, M)> c = a;
+    return c -= b;
+}
+
+template<size_t N>
+constexpr auto operator-(const UInt<N>& a, const uint64_t& b) noexcept
+{
+    return a - UInt<64>(b);
+}
+
+template<size_t N>
+constexpr auto operator-(const uint64_t& a, const UInt<N>& b) noexcept
+{
+    return UInt<64>(a) - b;
+}
+
+template<size_t N>
+template<size_t M>
+constexpr UInt<N>& UInt<N>::operator-=(const UInt<M>& a) noexcept
+{
+    implementation_detail::sub(data, data, limb_count, a.data, std::min(limb_count, UInt<M>::limb_count));
+    truncate();
+
+    return *this;
+}
+
+template<size_t N>
+constexpr UInt<N>& UInt<N>::operator-=(uint64_t a) noexcept
+{
+    implementation_detail::sub_1(data, data, limb_count, a);
+    truncate();
+
+    return *this;
+}
+
+
+// *, *= operators
+template<size_t N, size_t M>
+constexpr auto operator*(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    UInt<std::max(N, M)> total;
+    implementation_detail::mul_fixed<UInt<N>::limb_count, UInt<M>::limb_count, UInt<std::max(N, M)>::limb_count>(
+        total.data, a.data, b.data);
+    total.truncate();
+
+    return total;
+}
+
+// Full product, nothing is truncated
+template<size_t N, size_t M>
+constexpr UInt<N + M> wide_mul(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    UInt<N + M> total;
+    implementation_detail::mul_fixed<UInt<N>::limb_count, UInt<M>::limb_count, UInt<N + M>::limb_count>(
+        total.data, a.data, b.data);
+
+    return total;
+}
+
 template<size_t N>
-class UInt;
+constexpr auto operator*(const UInt<N>& a, uint64_t b) noexcept
+{
+    return a * UInt<64>(b);
+}
 
+template<size_t N>
+constexpr auto operator*(uint64_t a, const UInt<N>& b) noexcept
+{
+    return UInt<64>(a) * b;
+}
 
 template<size_t N>
-class UInt
+template<size_t M>
+constexpr UInt<N>& UInt<N>::operator*=(const UInt<M>& a) noexcept
 {
-    template<size_t M>
-    friend class UInt;
-    template<size_t M>
-    friend constexpr UInt<M> operator~(UInt<M> n) noexcept;
-    template<size_t M>
-    friend std::ostream& operator<<(std::ostream& out, const UInt<M>& n) noexcept;
-    template<size_t L, size_t M>
-    friend constexpr auto operator*(const UInt<L>& a, const UInt<M>& b) noexcept;
+    UInt<N> total;
+    implementation_detail::mul_fixed<limb_count, std::min(limb_count, UInt<M>::limb_count), limb_count>(
+        total.data, data, a.data);
+    total.truncate();
 
-    public:
-        // Constructors
-        constexpr UInt() noexcept;
-        constexpr UInt(const uint64_t& ull) noexcept;
-        constexpr UInt(const UInt& a) noexcept;
-        template<size_t M>
-        constexpr UInt(const UInt<M>& a) noexcept;
+    return *this = total;
+}
 
-        // Assignment operators
-        template<size_t M>
-        constexpr UInt& operator=(const UInt<M>& a) noexcept;
+template<size_t N>
+constexpr UInt<N>& UInt<N>::operator*=(uint64_t a) noexcept
+{
+    implementation_detail::mul_1(data, data, limb_count, a);
+    truncate();
 
-        // Bit manipulation-assignement operator
-        template<size_t M>
-        constexpr UInt& operator&=(const UInt<M>& a) noexcept;
-        constexpr UInt& operator&=(const uint64_t& a) noexcept;
-        template<size_t M>
-        constexpr UInt& operator|=(const UInt<M>& a) noexcept;
-        constexpr UInt& operator|=(const uint64_t& a) noexcept;
-        template<size_t M>
-        constexpr UInt& operator^=(const UInt<M>& a) noexcept;
-        constexpr UInt& operator^=(const uint64_t& a) noexcept;
-        constexpr UInt& operator<<=(size_t n) noexcept;
-        constexpr UInt& operator>>=(size_t n) noexcept;
+    return *this;
+}
 
-        // Arithmetic-assignement operators
-        template<size_t M>
-        constexpr UInt& operator+=(const UInt<M>& a) noexcept;
-        constexpr UInt& operator+=(uint64_t a) noexcept;
-        template<size_t M>
-        constexpr UInt& operator-=(const UInt<M>& a) noexcept;
-        constexpr UInt& operator-=(uint64_t a) noexcept;
-        template<size_t M>
-        constexpr UInt& operator*=(const UInt<M>& a) noexcept;
-        constexpr UInt& operator*=(uint64_t a) noexcept;
-        template<size_t M>
-        constexpr UInt& operator/=(const UInt<M>& a) noexcept;
-        template<size_t M>
-        constexpr UInt& operator%=(const UInt<M>& a) noexcept;
 
+// Squares, every cross product being computed once
+template<size_t N>
+constexpr UInt<N> sqr(const UInt<N>& a) noexcept
+{
+    UInt<N> total;
+    implementation_detail::sqr_fixed<UInt<N>::limb_count, UInt<N>::limb_count>(total.data, a.data);
+    total.truncate();
 
-    private:
+    return total;
+}
 
-        uint32_t data[ceil_div<32>(N)] = {};
+// Full square, nothing is truncated
+template<size_t N>
+constexpr UInt<2 * N> wide_sqr(const UInt<N>& a) noexcept
+{
+    UInt<2 * N> total;
+    implementation_detail::sqr_fixed<UInt<N>::limb_count, UInt<2 * N>::limb_count>(total.data, a.data);
 
-        void write_hex(std::ostream& out) const noexcept;
-        constexpr void truncate() noexcept;
-};
+    return total;
+}
+
+
+// Fused multiply-add
+// acc += a * b, the product being accumulated row by row into acc instead of going through a temporary when it
+// is computed by the schoolbook method. The product is not truncated to the width of a and b, only the sum to the
+// one of acc
+template<size_t N, size_t L, size_t M>
+constexpr UInt<N>& mul_add(UInt<N>& acc, const UInt<L>& a, const UInt<M>& b) noexcept
+{
+    constexpr size_t n = UInt<N>::limb_count;
+    constexpr size_t na = std::min(UInt<L>::limb_count, n);
+    constexpr size_t nb = std::min(UInt<M>::limb_count, n);
+    if constexpr(std::min(na, nb) < (n <= std::max(na, nb) ? 2 : 1) * implementation_detail::karatsuba_threshold)
+        implementation_detail::addmul_low(acc.data, n, a.data, na, b.data, nb);
+    else
+    {
+        uint64_t product[n] = {};
+        implementation_detail::mul_fixed<na, nb, n>(product, a.data, b.data);
+        implementation_detail::add_n(acc.data, acc.data, product, n);
+    }
+    acc.truncate();
+
+    return acc;
+}
+
+// acc += a * b, in a single pass over a
+template<size_t N, size_t M>
+constexpr UInt<N>& mul_add_word(UInt<N>& acc, const UInt<M>& a, uint64_t b) noexcept
+{
+    constexpr size_t n = UInt<N>::limb_count;
+    constexpr size_t na = std::min(UInt<M>::limb_count, n);
+    const uint64_t carry = implementation_detail::addmul_1(acc.data, a.data, na, b);
+    implementation_detail::propagate(acc.data + na, n - na, carry);
+    acc.truncate();
+
+    return acc;
+}
+
+
+// divmod, /, /=, %, %= operators
+// Quotient and remainder of a by b, b must not be zero (both are zero if it is). The remainder is as wide as the
+// narrower operand
+template<size_t N, size_t M>
+constexpr auto divmod(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    std::pair<UInt<N>, UInt<std::min(N, M)>> result;
+    const size_t na = implementation_detail::significant(a.data, UInt<N>::limb_count);
+    const size_t nb = implementation_detail::significant(b.data, UInt<M>::limb_count);
+
+    if(na < nb)
+        result.second = a;
+    else
+    {
+        uint64_t scratch[implementation_detail::div_scratch(UInt<N>::limb_count, UInt<M>::limb_count)] = {};
+        implementation_detail::divrem(result.first.data, result.second.data, a.data, na, b.data, nb, scratch);
+    }
+
+    return result;
+}
 
-// Constructors
 template<size_t N>
-constexpr UInt<N>::UInt() noexcept
+constexpr std::pair<UInt<N>, uint64_t> divmod(const UInt<N>& a, uint64_t b) noexcept
 {
-    static_assert(N>0, "number of bits must be greater than 0");
+    std::pair<UInt<N>, uint64_t> result;
+    result.second = implementation_detail::divrem_1(result.first.data, a.data, UInt<N>::limb_count, b);
+
+    return result;
+}
+
+template<size_t N, size_t M>
+constexpr UInt<N> operator/(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    return divmod(a, b).first;
 }
 
 template<size_t N>
-constexpr UInt<N>::UInt(const uint64_t& ull) noexcept : UInt ()
+constexpr UInt<N> operator/(const UInt<N>& a, const uint64_t& b) noexcept
 {
-    data[0] = ull & 0xFFFFFFFF;
-    if(N > 32) data[1] = ull >> 32;
-    truncate();
+    return divmod(a, b).first;
 }
 
 template<size_t N>
-constexpr UInt<N>::UInt(const UInt& a) noexcept : UInt()
+constexpr UInt<64> operator/(const uint64_t& a, const UInt<N>& b) noexcept
 {
-    std::copy(a.data, a.data+ceil_div<32>(N), data);
-    truncate();
+    return UInt<64>(a) / b;
 }
 
 template<size_t N>
 template<size_t M>
-constexpr UInt<N>::UInt(const UInt<M>& a) noexcept : UInt()
+constexpr UInt<N>& UInt<N>::operator/=(const UInt<M>& a) noexcept
 {
-    std::copy(a.data, a.data+ceil_div<32>(std::min(N, M)), data);
-    truncate();
+    return *this = divmod(*this, a).first;
 }
 
+template<size_t N>
+constexpr UInt<N>& UInt<N>::operator/=(uint64_t a) noexcept
+{
+    implementation_detail::divrem_1(data, data, limb_count, a);
+
+    return *this;
+}
+
+template<size_t N, size_t M>
+constexpr UInt<std::min(N, M)> operator%(const UInt<N>& a, const UInt<M>& b) noexcept
+{
+    return divmod(a, b).second;
+}
+
+template<size_t N>
+constexpr UInt<std::min(N, size_t(64))> operator%(const UInt<N>& a, const uint64_t& b) noexcept
+{
+    return divmod(a, b).second;
+}
+
+template<size_t N>
+constexpr UInt<std::min(N, size_t(64))> operator%(const uint64_t& a, const UInt<N>& b) noexcept
+{
+    return UInt<64>(a) % b;
+}
 
-// Assignment operators
 template<size_t N>
 template<size_t M>
-constexpr UInt<N>& UInt<N>::operator=(const UInt<M>& a) noexcept
+constexpr UInt<N>& UInt<N>::operator%=(const UInt<M>& a) noexcept
 {
-    for(size_t i = 0; i < ceil_div<32>(std::min(N, M)); ++i)
-        data[i] = a.data[i];
-    for(size_t i = ceil_div<32>(std::min(N, M)); i < ceil_div<32>(N); ++i)
-        data[i] = 0;
-    truncate();
+    return *this = divmod(*this, a).second;
+}
 
-    return *this;
+template<size_t N>
+constexpr UInt<N>& UInt<N>::operator%=(uint64_t a) noexcept
+{
+    return *this = divmod(*this, a).second;
 }
 
 
-// ~ operator
+// String conversions
+// Same contract as std::to_chars, for a base from 2 to 36
 template<size_t N>
-constexpr UInt<N> operator~(UInt<N> n) noexcept
+constexpr std::to_chars_result to_chars(char* first, char* last, const UInt<N>& value, int base) noexcept
 {
-    for(auto& elem : n.data)
-        elem = ~elem;
-    n.truncate();
-    return n;
+    uint64_t scratch[implementation_detail::to_chars_scratch(UInt<N>::limb_count)] = {};
+    char* end = implementation_detail::to_chars(first, last, value.data, UInt<N>::limb_count,
+                                                static_cast<unsigned>(base), scratch);
+    if(end == nullptr)
+        return {last, std::errc::value_too_large};
+
+    return {end, std::errc()};
 }
 
+// Same contract as std::from_chars, for a base from 2 to 36
+template<size_t N>
+constexpr std::from_chars_result from_chars(const char* first, const char* last, UInt<N>& value, int base) noexcept
+{
+    const char* end = first;
+    while(end != last && implementation_detail::digit_value(*end) < static_cast<unsigned>(base))
+        ++end;
+    if(end == first)
+        return {first, std::errc::invalid_argument};
+
+    // Leading zeros aside, a value of N bits has at most N / floor(log2(base)) + 1 digits
+    const char* digits = first;
+    while(digits + 1 != end && *digits == '0')
+        ++digits;
+    size_t log2_base = 0;
+    for(int b = base; b > 1; b >>= 1)
+        ++log2_base;
+    if(static_cast<size_t>(end - digits) > N / log2_base + 1)
+        return {end, std::errc::result_out_of_range};
+
+    // Enough limbs for that many digits in any base, 3 being the worst
+    constexpr size_t n = N / 32 + 2;
+    uint64_t r[n] = {}, scratch[implementation_detail::from_chars_scratch(n)] = {};
+    const size_t size = implementation_detail::from_chars(r, digits, static_cast<size_t>(end - digits),
+                                                          static_cast<unsigned>(base), scratch);
+    if(size > UInt<N>::limb_count || (N % 64 != 0 && size == UInt<N>::limb_count && r[size-1] >> (N % 64) != 0))
+        return {end, std::errc::result_out_of_range};
+
+    value = UInt<N>();
+    implementation_detail::copy(value.data, r, size);
+
+    return {end, std::errc()};
+}
 
-// &, &= operators
-template<size_t N, size_t M>
-constexpr auto operator&(const UInt<N>& a, const UInt<M>& b) noexcept
+template<size_t N>
+std::ostream& operator<<(std::ostream& out, const UInt<N>& n) noexcept
 {
-    UInt<std::max(N, M)> c = a;
-    return c &= b;
-};
+    auto flags = out.flags();
+    if(flags & std::ios::hex)
+        n.write_hex(out);
+    else
+    {
+        // Octal takes the most digits
+        char buffer[N / 3 + 2] = {};
+        const auto result = to_chars(buffer, buffer + sizeof(buffer), n, (flags & std::ios::oct) ? 8 : 10);
+        out << std::string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+
+    return out;
+}
 
+// Reads the digits in the base of the stream (decimal, hexadecimal or octal), sets failbit when there are none or
+// when the value does not fit
 template<size_t N>
-constexpr auto operator&(const UInt<N>& a, const uint64_t& b) noexcept
+std::istream& operator>>(std::istream& in, UInt<N>& n)
 {
-    return a & UInt<64>(b);
+    std::istream::sentry sentry(in);
+    if(!sentry)
+        return in;
+
+    const auto flags = in.flags();
+    const int base = (flags & std::ios::hex) ? 16 : (flags & std::ios::oct) ? 8 : 10;
+    std::string digits;
+    for(;;)
+    {
+        const auto c = in.peek();
+        if(c == std::istream::traits_type::eof())
+        {
+            in.setstate(std::ios::eofbit);
+            break;
+        }
+        if(implementation_detail::digit_value(static_cast<char>(c)) >= static_cast<unsigned>(base))
+            break;
+        digits.push_back(static_cast<char>(in.get()));
+    }
+
+    if(from_chars(digits.data(), digits.data() + digits.size(), n, base).ec != std::errc())
+        in.setstate(std::ios::failbit);
+
+    return in;
+}
+
+template<size_t N>
+void UInt<N>::write_hex(std::ostream& out) const noexcept
+{
+    auto flags = out.flags();
+    size_t i = limb_count;
+
+    bool zero = true;
+    while(zero && i-- > 0)
+    {
+        if(data[i] != 0)
+            zero = false;
+    }
+
+    if(zero)
+    {
+        out << 0;
+        return;
+    }
+
+    out << data[i];
+    out.unsetf(std::ios_base::showbase | std::ios_base::showpos);
+
+    while(i-- > 0)
+    {
+        out << std::setw(16) << std::setfill('0') << std::right << data[i];
+    }
+
+    out.flags(flags);
+}
+
+
+template<size_t N>
+inline constexpr void UInt<N>::truncate() noexcept
+{
+    if constexpr(N % 64 != 0)
+        data[limb_count - 1] &= (uint64_t(1) << (N % 64)) - 1;
+}
+
+
+// Constant-time operations, for values that must not leak through timing such as key material
+template<size_t N>
+constexpr bool equal(const UInt<N>& a, const UInt<N>& b, constant_time_t) noexcept
+{
+    return implementation_detail::ct_equal(a.data, b.data, UInt<N>::limb_count);
+}
+
+// -1, 0 or 1 as a is below, equal to or above b
+template<size_t N>
+constexpr int compare(const UInt<N>& a, const UInt<N>& b, constant_time_t) noexcept
+{
+    constexpr size_t n = UInt<N>::limb_count;
+    return static_cast<int>(implementation_detail::ct_less(b.data, a.data, n)) -
+           static_cast<int>(implementation_detail::ct_less(a.data, b.data, n));
+}
+
+// c ? a : b
+template<size_t N>
+constexpr UInt<N> select(bool c, const UInt<N>& a, const UInt<N>& b, constant_time_t) noexcept
+{
+    UInt<N> result;
+    const uint64_t mask = implementation_detail::ct_mask(c);
+    implementation_detail::ct_select(result.data, a.data, b.data, UInt<N>::limb_count, mask);
+
+    return result;
+}
+
+// Swaps a and b when c is true
+template<size_t N>
+constexpr void cswap(bool c, UInt<N>& a, UInt<N>& b, constant_time_t) noexcept
+{
+    implementation_detail::ct_swap(a.data, b.data, UInt<N>::limb_count, implementation_detail::ct_mask(c));
+}
+
+
+// Modular arithmetic
+// Inverse of a modulo m, 0 when a and m are not coprime. Extended Euclid keeping only the magnitude of the
+// coefficients of a, their signs alternating
+template<size_t N>
+constexpr UInt<N> modinv(const UInt<N>& a, const UInt<N>& m) noexcept
+{
+    constexpr size_t n = UInt<N>::limb_count;
+    UInt<N> r0 = m, r1 = divmod(a, m).second, t0 = 0, t1 = 1;
+    bool t0_negative = false, t1_negative = false;
+    while(implementation_detail::significant(r1.data, n) != 0)
+    {
+        auto [q, r2] = divmod(r0, r1);
+        const UInt<N> t2 = t0 + q * t1;
+        r0 = r1;
+        r1 = r2;
+        t0 = t1;
+        t1 = t2;
+        t0_negative = t1_negative;
+        t1_negative = !t1_negative;
+    }
+
+    const uint64_t one = 1;
+    if(implementation_detail::cmp(r0.data, n, &one, 1) != 0)
+        return UInt<N>();
+
+    return t0_negative ? m - t0 : t0;
+}
+
+// Precomputed context for the arithmetic modulo an odd m in Montgomery form (a R mod m with R = 2^(64 limb_count)),
+// every product being reduced without division
+template<size_t N>
+class Montgomery
+{
+    public:
+        static constexpr size_t limb_count = UInt<N>::limb_count;
+
+        // Constructors
+        constexpr explicit Montgomery(const UInt<N>& m) noexcept;
+
+        // Getters
+        constexpr const UInt<N>& modulus() const noexcept { return m_; }
+        // 1 in Montgomery form
+        constexpr const UInt<N>& one() const noexcept { return one_; }
+
+        // Conversions, a can be any value
+        constexpr UInt<N> to_montgomery(const UInt<N>& a) const noexcept { return mul(a, r2_); }
+        constexpr UInt<N> from_montgomery(const UInt<N>& a) const noexcept;
+
+        // Operations on values in Montgomery form
+        constexpr UInt<N> mul(const UInt<N>& a, const UInt<N>& b) const noexcept;
+        constexpr UInt<N> sqr(const UInt<N>& a) const noexcept;
+        template<size_t M>
+        constexpr UInt<N> pow(const UInt<N>& a, const UInt<M>& e) const noexcept;
+
+        // Operations on plain values, inputs must be below the modulus
+        constexpr UInt<N> modmul(const UInt<N>& a, const UInt<N>& b) const noexcept { return mul(to_montgomery(a), b); }
+        template<size_t M>
+        constexpr UInt<N> modpow(const UInt<N>& a, const UInt<M>& e) const noexcept;
+
+        // Constant-time versions: schoolbook products, branch-free reduction and fixed windows whose powers are
+        // read by scanning the whole table. The modulus is considered public
+        constexpr UInt<N> mul(const UInt<N>& a, const UInt<N>& b, constant_time_t) const noexcept;
+        constexpr UInt<N> sqr(const UInt<N>& a, constant_time_t) const noexcept;
+        template<size_t M>
+        constexpr UInt<N> pow(const UInt<N>& a, const UInt<M>& e, constant_time_t) const noexcept;
+        template<size_t M>
+        constexpr UInt<N> modpow(const UInt<N>& a, const UInt<M>& e, constant_time_t) const noexcept;
+
+    private:
+        UInt<N> m_;
+        UInt<N> one_;
+        UInt<N> r2_;
+        uint64_t minv_ = 0;
 };
 
 template<size_t N>
-constexpr auto operator&(const uint64_t& a, const UInt<N>& b) noexcept
+constexpr Montgomery<N>::Montgomery(const UInt<N>& m) noexcept : m_(m)
+{
+    // Newton iteration for 1/m modulo 2^64, m being its own inverse modulo 8
+    uint64_t inverse = m.data[0];
+    for(int i = 0; i < 5; ++i)
+        inverse *= 2 - m.data[0] * inverse;
+    minv_ = -inverse;
+
+    // R and R^2 modulo m are the only divisions
+    const size_t nm = implementation_detail::significant(m.data, limb_count);
+    uint64_t power[2 * limb_count + 1] = {}, quotient[2 * limb_count + 1] = {};
+    uint64_t scratch[implementation_detail::div_scratch(2 * limb_count + 1, limb_count)] = {};
+    power[limb_count] = 1;
+    implementation_detail::divrem(quotient, one_.data, power, limb_count + 1, m.data, nm, scratch);
+    power[limb_count] = 0;
+    power[2 * limb_count] = 1;
+    implementation_detail::divrem(quotient, r2_.data, power, 2 * limb_count + 1, m.data, nm, scratch);
+}
+
+template<size_t N>
+constexpr UInt<N> Montgomery<N>::from_montgomery(const UInt<N>& a) const noexcept
 {
-    return UInt<64>(a) & b;
-};
+    UInt<N> result;
+    uint64_t t[2 * limb_count] = {};
+    implementation_detail::copy(t, a.data, limb_count);
+    implementation_detail::redc(result.data, t, m_.data, limb_count, minv_);
+
+    return result;
+}
 
 template<size_t N>
-template<size_t M>
-constexpr UInt<N>& UInt<N>::operator&=(const UInt<M>& a) noexcept
+constexpr UInt<N> Montgomery<N>::mul(const UInt<N>& a, const UInt<N>& b) const noexcept
 {
-    for(size_t i = 0; i < ceil_div<32>(std::min(N, M)); ++i)
-        data[i] &= a.data[i];
-    for(size_t i = ceil_div<32>(std::min(N, M)); i < ceil_div<32>(N); ++i)
-        data[i] = 0;
-    truncate();
+    UInt<N> result;
+    uint64_t t[2 * limb_count] = {};
+    implementation_detail::mul_fixed<limb_count, limb_count, 2 * limb_count>(t, a.data, b.data);
+    implementation_detail::redc(result.data, t, m_.data, limb_count, minv_);
 
-    return *this;
+    return result;
 }
 
 template<size_t N>
-constexpr UInt<N>& UInt<N>::operator&=(const uint64_t& a) noexcept
+constexpr UInt<N> Montgomery<N>::sqr(const UInt<N>& a) const noexcept
 {
-    data[0] &= a;
-    if(ceil_div<32>(N) > 1)
-    {
-        data[1] &= (a >> 32);
-        for(size_t i = 2; i < ceil_div<32>(N); ++i)
-            data[i] = 0;
-    }
-    truncate();
+    UInt<N> result;
+    uint64_t t[2 * limb_count] = {};
+    implementation_detail::sqr_fixed<limb_count, 2 * limb_count>(t, a.data);
+    implementation_detail::redc(result.data, t, m_.data, limb_count, minv_);
 
-    return *this;
+    return result;
 }
 
+template<size_t N>
+template<size_t M>
+constexpr UInt<N> Montgomery<N>::pow(const UInt<N>& a, const UInt<M>& e) const noexcept
+{
+    return implementation_detail::pow_sliding_window(*this, a, e.data, UInt<M>::limb_count);
+}
 
-// |, |= operators
-template<size_t N, size_t M>
-constexpr auto operator|(const UInt<N>& a, const UInt<M>& b) noexcept
+template<size_t N>
+template<size_t M>
+constexpr UInt<N> Montgomery<N>::modpow(const UInt<N>& a, const UInt<M>& e) const noexcept
 {
-    UInt<std::max(N, M)> c = a;
-    return c |= b;
-};
+    return from_montgomery(pow(to_montgomery(a), e));
+}
 
 template<size_t N>
-constexpr auto operator|(const UInt<N>& a, const uint64_t& b) noexcept
+constexpr UInt<N> Montgomery<N>::mul(const UInt<N>& a, const UInt<N>& b, constant_time_t) const noexcept
 {
-    return a | UInt<64>(b);
-};
+    // The subquadratic products branch on the values, the basecase does not
+    UInt<N> result;
+    uint64_t t[2 * limb_count] = {};
+    implementation_detail::mul(t, a.data, limb_count, b.data, limb_count);
+    implementation_detail::ct_redc(result.data, t, m_.data, limb_count, minv_);
+
+    return result;
+}
 
 template<size_t N>
-constexpr auto operator|(const uint64_t& a, const UInt<N>& b) noexcept
+constexpr UInt<N> Montgomery<N>::sqr(const UInt<N>& a, constant_time_t) const noexcept
 {
-    return UInt<64>(a) | b;
-};
+    UInt<N> result;
+    uint64_t t[2 * limb_count] = {};
+    implementation_detail::sqr(t, a.data, limb_count);
+    implementation_detail::ct_redc(result.data, t, m_.data, limb_count, minv_);
+
+    return result;
+}
 
 template<size_t N>
 template<size_t M>
-constexpr UInt<N>& UInt<N>::operator|=(const UInt<M>& a) noexcept
+constexpr UInt<N> Montgomery<N>::pow(const UInt<N>& a, const UInt<M>& e, constant_time_t) const noexcept
 {
-    for(size_t i = 0; i < ceil_div<32>(std::min(N, M)); ++i)
-        data[i] |= a.data[i];
-    truncate();
+    // Every bit of e is processed, from the top, w at a time: w squarings then a multiplication, even by one
+    constexpr size_t n = UInt<M>::limb_count;
+    constexpr size_t w = implementation_detail::ct_window_size(64 * n);
+    constexpr size_t windows = (64 * n + w - 1) / w;
+    constexpr size_t entries = size_t(1) << w;
+
+    UInt<N> table[entries];
+    table[0] = one_;
+    table[1] = a;
+    for(size_t k = 2; k < entries; ++k)
+        table[k] = (k % 2 == 0) ? sqr(table[k / 2], constant_time) : mul(table[k-1], a, constant_time);
+
+    UInt<N> result = one_, power;
+    for(size_t i = windows; i-- > 0;)
+    {
+        if(i + 1 != windows)
+            for(size_t k = 0; k < w; ++k)
+                result = sqr(result, constant_time);
+
+        const uint64_t digit = implementation_detail::bits_at(e.data, n, i * w, w);
+        for(size_t k = 0; k < entries; ++k)
+        {
+            const uint64_t mask = implementation_detail::ct_mask(implementation_detail::ct_is_zero(k ^ digit));
+            implementation_detail::ct_select(power.data, table[k].data, power.data, limb_count, mask);
+        }
+        result = mul(result, power, constant_time);
+    }
 
-    return *this;
+    return result;
 }
 
 template<size_t N>
-constexpr UInt<N>& UInt<N>::operator|=(const uint64_t& a) noexcept
+template<size_t M>
+constexpr UInt<N> Montgomery<N>::modpow(const UInt<N>& a, const UInt<M>& e, constant_time_t) const noexcept
 {
-    data[0] |= a;
-    if(ceil_div<32>(N) > 1)
-        data[1] |= (a >> 32);
-    truncate();
+    UInt<N> result;
+    uint64_t t[2 * limb_count] = {};
+    const UInt<N> power = pow(mul(a, r2_, constant_time), e, constant_time);
+    implementation_detail::copy(t, power.data, limb_count);
+    implementation_detail::ct_redc(result.data, t, m_.data, limb_count, minv_);
 
-    return *this;
+    return result;
 }
 
 
-// ^, ^= operators
-template<size_t N, size_t M>
-constexpr auto operator^(const UInt<N>& a, const UInt<M>& b) noexcept
-{
-    UInt<std::max(N, M)> c = a;
-    return c ^= b;
-};
-
+// Precomputed context for the arithmetic modulo any non-zero m, every product being reduced with a precomputed
+// reciprocal of m (Barrett reduction) instead of a division
 template<size_t N>
-constexpr auto operator^(const UInt<N>& a, const uint64_t& b) noexcept
+class Barrett
 {
-    return a ^ UInt<64>(b);
+    public:
+        static constexpr size_t limb_count = UInt<N>::limb_count;
+
+        // Constructors
+        constexpr explicit Barrett(const UInt<N>& m) noexcept;
+
+        // Getters
+        constexpr const UInt<N>& modulus() const noexcept { return m_; }
+        constexpr UInt<N> one() const noexcept { return reduce(UInt<2 * N>(1)); }
+
+        // x modulo m, x must be below m^2
+        constexpr UInt<N> reduce(const UInt<2 * N>& x) const noexcept;
+
+        // Operations, inputs must be below the modulus (any base is accepted by modpow)
+        constexpr UInt<N> mul(const UInt<N>& a, const UInt<N>& b) const noexcept { return reduce(wide_mul(a, b)); }
+        constexpr UInt<N> sqr(const UInt<N>& a) const noexcept;
+        constexpr UInt<N> modmul(const UInt<N>& a, const UInt<N>& b) const noexcept { return mul(a, b); }
+        template<size_t M>
+        constexpr UInt<N> modpow(const UInt<N>& a, const UInt<M>& e) const noexcept;
+
+    private:
+        UInt<N> m_;
+        uint64_t mu_[limb_count + 2] = {};
+        size_t k_ = 0;
 };
 
 template<size_t N>
-constexpr auto operator^(const uint64_t& a, const UInt<N>& b) noexcept
+constexpr Barrett<N>::Barrett(const UInt<N>& m) noexcept :
+    m_(m),
+    k_(implementation_detail::significant(m.data, limb_count))
 {
-    return UInt<64>(a) ^ b;
-};
+    // floor(2^(128k) / m), which takes k + 2 limbs when m is a power of 2^64
+    uint64_t power[2 * limb_count + 1] = {}, quotient[limb_count + 2] = {}, remainder[limb_count] = {};
+    uint64_t scratch[implementation_detail::div_scratch(2 * limb_count + 1, limb_count)] = {};
+    power[2 * k_] = 1;
+    implementation_detail::divrem(quotient, remainder, power, 2 * k_ + 1, m.data, k_, scratch);
+    implementation_detail::copy(mu_, quotient, k_ + 2);
+}
 
 template<size_t N>
-template<size_t M>
-constexpr UInt<N>& UInt<N>::operator^=(const UInt<M>& a) noexcept
+constexpr UInt<N> Barrett<N>::reduce(const UInt<2 * N>& x) const noexcept
 {
-    for(size_t i = 0; i < ceil_div<32>(std::min(N, M)); ++i)
-        data[i] ^= a.data[i];
-    truncate();
+    // x is widened to 2 limb_count limbs, which UInt<2N> can be one short of
+    UInt<N> result;
+    uint64_t t[2 * limb_count] = {}, scratch[implementation_detail::barrett_scratch(limb_count)] = {};
+    implementation_detail::copy(t, x.data, UInt<2 * N>::limb_count);
+    implementation_detail::barrett_reduce(result.data, t, m_.data, mu_, k_, scratch);
 
-    return *this;
+    return result;
 }
 
 template<size_t N>
-constexpr UInt<N>& UInt<N>::operator^=(const uint64_t& a) noexcept
+constexpr UInt<N> Barrett<N>::sqr(const UInt<N>& a) const noexcept
 {
-    data[0] ^= a;
-    if(ceil_div<32>(N) > 1)
-        data[1] ^= (a >> 32);
-    truncate();
+    UInt<N> result;
+    uint64_t t[2 * limb_count] = {}, scratch[implementation_detail::barrett_scratch(limb_count)] = {};
+    implementation_detail::sqr_fixed<limb_count, 2 * limb_count>(t, a.data);
+    implementation_detail::barrett_reduce(result.data, t, m_.data, mu_, k_, scratch);
 
-    return *this;
+    return result;
 }
 
-
-// <<, <<= operators
 template<size_t N>
-constexpr UInt<N> operator<<(const UInt<N>& a, uint64_t n) noexcept
+template<size_t M>
+constexpr UInt<N> Barrett<N>::modpow(const UInt<N>& a, const UInt<M>& e) const noexcept
 {
-    UInt<N> c = a;
-    return c <<= n;
+    return implementation_detail::pow_sliding_window(*this, divmod(a, m_).second, e.data, UInt<M>::limb_count);
 }
 
+
+// a * b modulo m, m must not be zero
 template<size_t N>
-constexpr UInt<N>& UInt<N>::operator<<=(size_t n) noexcept
+constexpr UInt<N> modmul(const UInt<N>& a, const UInt<N>& b, const UInt<N>& m) noexcept
 {
-    size_t m = n / 32;
-    size_t l = n % 32;
-
-    for(size_t i = ceil_div<32>(N); i > 0; --i)
-    {
-        uint32_t temp = (i > m+1 ? data[i-m-2] >> (32-l) : 0);
-        data[i-1] = ((i > m ? data[i-m-1] : 0) << l) + temp;
-    }
-    truncate();
-
-    return *this;
+    return divmod(wide_mul(a, b), m).second;
 }
 
+// a^e modulo m, m must not be zero. Odd moduli go through Montgomery, even ones through Barrett
+template<size_t N, size_t M>
+constexpr UInt<N> modpow(const UInt<N>& a, const UInt<M>& e, const UInt<N>& m) noexcept
+{
+    if(m.data[0] & 1)
+        return Montgomery<N>(m).modpow(a, e);
+    return Barrett<N>(m).modpow(a, e);
+}
 
-// >>, >>= operators
-template<size_t N>
-constexpr UInt<N> operator>>(const UInt<N>& a, uint64_t n) noexcept
+// a^e modulo an odd m in constant time, a must be below m. The modulus is considered public
+template<size_t N, size_t M>
+constexpr UInt<N> modpow(const UInt<N>& a, const UInt<M>& e, const UInt<N>& m, constant_time_t) noexcept
 {
-    UInt<N> c = a;
-    return c >>= n;
+    return Montgomery<N>(m).modpow(a, e, constant_time);
 }
 
+// Fixed width signed integer of N bits in two's complement. The bits are kept in a UInt<N>, so that the additive and
+// multiplicative operators are the unsigned ones and only the sign-dependent operations have their own code.
+// Like the built-in integers, overflows wrap around, the quotient is truncated toward zero and >> is arithmetic
 template<size_t N>
-constexpr UInt<N>& UInt<N>::operator>>=(size_t n) noexcept
+class Int
 {
-    size_t m = n / 32;
-    size_t l = n % 32;
+    template<size_t M>
+    friend class Int;
 
-    for(size_t i = 0; i < ceil_div<32>(N); ++i)
-    {
-        uint32_t temp = (i+m+1 < ceil_div<32>(N) ? data[i+m+1] << (32-l) : 0);
-        data[i] = ((i+m > ceil_div<32>(N) ? data[i-m] : 0) >> l) + temp;
-    }
-    truncate();
+    public:
+        // Constructors, an Int<M> or an int64_t is sign-extended or truncated
+        constexpr Int() noexcept = default;
+        constexpr Int(int64_t a) noexcept;
+        template<size_t M>
+        explicit constexpr Int(const Int<M>& a) noexcept;
+        // Reinterprets the bits of a
+        explicit constexpr Int(const UInt<N>& a) noexcept : bits_{a} {}
+
+        // Getters
+        constexpr bool is_zero() const noexcept { return bits_ == 0u; }
+        constexpr bool is_negative() const noexcept;
+        // -1, 0 or 1
+        constexpr int sign() const noexcept { return is_negative() ? -1 : !is_zero(); }
+        // Two's complement bits
+        constexpr const UInt<N>& bits() const noexcept { return bits_; }
+        // |a|, which always fits even for the smallest value
+        constexpr UInt<N> magnitude() const noexcept;
+
+        // Bit manipulation-assignement operators
+        constexpr Int& operator&=(const Int& a) noexcept { bits_ &= a.bits_; return *this; }
+        constexpr Int& operator|=(const Int& a) noexcept { bits_ |= a.bits_; return *this; }
+        constexpr Int& operator^=(const Int& a) noexcept { bits_ ^= a.bits_; return *this; }
+        constexpr Int& operator<<=(size_t n) noexcept { bits_ <<= n; return *this; }
+        constexpr Int& operator>>=(size_t n) noexcept;
+
+        // Arithmetic-assignement operators, dividing by zero is undefined like for UInt
+        constexpr Int& operator+=(const Int& a) noexcept { bits_ += a.bits_; return *this; }
+        constexpr Int& operator-=(const Int& a) noexcept { bits_ -= a.bits_; return *this; }
+        constexpr Int& operator*=(const Int& a) noexcept { bits_ *= a.bits_; return *this; }
+        constexpr Int& operator/=(const Int& a) noexcept { return *this = divmod(*this, a).first; }
+        constexpr Int& operator%=(const Int& a) noexcept { return *this = divmod(*this, a).second; }
+
+        // Operators, defined here so that an int64_t operand converts
+        friend constexpr Int operator~(Int a) noexcept { a.bits_ = ~a.bits_; return a; }
+        friend constexpr Int operator-(const Int& a) noexcept { return Int() -= a; }
+        friend constexpr Int operator&(Int a, const Int& b) noexcept { return a &= b; }
+        friend constexpr Int operator|(Int a, const Int& b) noexcept { return a |= b; }
+        friend constexpr Int operator^(Int a, const Int& b) noexcept { return a ^= b; }
+        friend constexpr Int operator<<(Int a, size_t n) noexcept { return a <<= n; }
+        friend constexpr Int operator>>(Int a, size_t n) noexcept { return a >>= n; }
+        friend constexpr Int operator+(Int a, const Int& b) noexcept { return a += b; }
+        friend constexpr Int operator-(Int a, const Int& b) noexcept { return a -= b; }
+        friend constexpr Int operator*(Int a, const Int& b) noexcept { return a *= b; }
+        friend constexpr Int operator/(Int a, const Int& b) noexcept { return a /= b; }
+        friend constexpr Int operator%(Int a, const Int& b) noexcept { return a %= b; }
+
+        // Quotient truncated toward zero and remainder of the sign of a, b must not be zero
+        friend constexpr std::pair<Int, Int> divmod(const Int& a, const Int& b) noexcept
+        {
+            const auto qr = divmod(a.magnitude(), b.magnitude());
+            const Int q(qr.first), r(qr.second);
+            return {a.is_negative() != b.is_negative() ? -q : q, a.is_negative() ? -r : r};
+        }
+
+        // -1, 0 or 1 as a is below, equal to or above b. With the same sign, the bits compare as unsigned values
+        friend constexpr int compare(const Int& a, const Int& b) noexcept
+        {
+            if(a.is_negative() != b.is_negative())
+                return a.is_negative() ? -1 : 1;
+            return compare(a.bits_, b.bits_);
+        }
+
+        friend constexpr bool operator==(const Int& a, const Int& b) noexcept { return a.bits_ == b.bits_; }
+        friend constexpr bool operator!=(const Int& a, const Int& b) noexcept { return a.bits_ != b.bits_; }
+        friend constexpr bool operator<(const Int& a, const Int& b) noexcept { return compare(a, b) < 0; }
+        friend constexpr bool operator<=(const Int& a, const Int& b) noexcept { return compare(a, b) <= 0; }
+        friend constexpr bool operator>(const Int& a, const Int& b) noexcept { return compare(a, b) > 0; }
+        friend constexpr bool operator>=(const Int& a, const Int& b) noexcept { return compare(a, b) >= 0; }
+#ifdef UTILITIES_BIG_INT_THREE_WAY_COMPARISON
+        friend constexpr std::strong_ordering operator<=>(const Int& a, const Int& b) noexcept
+        {
+            return compare(a, b) <=> 0;
+        }
+#endif
 
-    return *this;
-}
+    private:
+        // Copies bit m - 1 into the bits from m up
+        constexpr void sign_extend(size_t m) noexcept;
 
+        UInt<N> bits_;
+};
 
-// +, += operators
-template<size_t N, size_t M>
-constexpr auto operator+(const UInt<N>& a, const UInt<M>& b) noexcept
+// Constructors
+template<size_t N>
+constexpr Int<N>::Int(int64_t a) noexcept : bits_{static_cast<uint64_t>(a)}
 {
-    UInt<std::max(N, M)> c = a;
-    return c += b;
+    sign_extend(64);
 }
 
 template<size_t N>
-constexpr auto operator+(const UInt<N>& a, const uint64_t& b) noexcept
+template<size_t M>
+constexpr Int<N>::Int(const Int<M>& a) noexcept : bits_{a.bits_}
 {
-    return a + UInt<64>(b);
+    sign_extend(M);
 }
 
 template<size_t N>
-constexpr auto operator+(const uint64_t& a, const UInt<N>& b) noexcept
+constexpr void Int<N>::sign_extend(size_t m) noexcept
 {
-    return UInt<64>(a) + b;
+    if(m >= N || !((bits_.data[(m-1) / 64] >> ((m-1) % 64)) & 1))
+        return;
+
+    size_t i = m / 64;
+    if(m % 64 != 0)
+        bits_.data[i++] |= ~uint64_t(0) << (m % 64);
+    for(; i < UInt<N>::limb_count; ++i)
+        bits_.data[i] = ~uint64_t(0);
+    bits_.truncate();
 }
 
+
+// Getters
 template<size_t N>
-template<size_t M>
-constexpr UInt<N>& UInt<N>::operator+=(const UInt<M>& a) noexcept
+constexpr bool Int<N>::is_negative() const noexcept
 {
-    uint64_t carry = 0;
-    for(size_t i = 0; i < ceil_div<32>(std::min(N, M)); ++i)
-    {
-        carry += data[i] + a.data[i];
-        data[i] = carry;
-        carry >>= 32;
-    }
-    truncate();
+    return (bits_.data[(N-1) / 64] >> ((N-1) % 64)) & 1;
+}
 
-    return *this;
+template<size_t N>
+constexpr UInt<N> Int<N>::magnitude() const noexcept
+{
+    return is_negative() ? (-*this).bits_ : bits_;
 }
 
+
+// >>= operator, the vacated bits taking the sign: for a negative a, a >> n = ~(~a >> n)
 template<size_t N>
-constexpr UInt<N>& UInt<N>::operator+=(uint64_t a) noexcept
+constexpr Int<N>& Int<N>::operator>>=(size_t n) noexcept
 {
-    uint64_t carry = 0;
-    for(size_t i = 0; i < std::min(ceil_div<32>(N), static_cast<size_t>(2)); ++i)
-    {
-        carry += data[i] + (a & 0xFFFFFFFF);
-        data[i] = carry;
-        carry >>= 32;
-        a >>= 32;
-    }
-    truncate();
+    if(is_negative())
+        bits_ = ~(~bits_ >> n);
+    else
+        bits_ >>= n;
 
     return *this;
 }
 
 
-// -, -= operators
+// Full product, nothing is truncated
 template<size_t N, size_t M>
-constexpr auto operator-(const UInt<N>& a, const UInt<M>& b) noexcept
+constexpr Int<N + M> wide_mul(const Int<N>& a, const Int<M>& b) noexcept
 {
-    UInt<std::max(N, M)> c = a;
-    return c -= b;
+    const Int<N + M> product(wide_mul(a.magnitude(), b.magnitude()));
+    return a.is_negative() != b.is_negative() ? -product : product;
 }
 
+
+// String conversions, with a leading '-' for the negative values
+// Same contract as std::to_chars, for a base from 2 to 36
 template<size_t N>
-constexpr auto operator-(const UInt<N>& a, const uint64_t& b) noexcept
+constexpr std::to_chars_result to_chars(char* first, char* last, const Int<N>& value, int base = 10) noexcept
 {
-    return a - UInt<64>(b);
+    if(value.is_negative())
+    {
+        if(first == last)
+            return {last, std::errc::value_too_large};
+        *first++ = '-';
+    }
+
+    return to_chars(first, last, value.magnitude(), base);
 }
 
+// Same contract as std::from_chars, for a base from 2 to 36
 template<size_t N>
-constexpr auto operator-(const uint64_t& a, const UInt<N>& b) noexcept
+constexpr std::from_chars_result from_chars(const char* first, const char* last, Int<N>& value, int base = 10) noexcept
 {
-    return UInt<64>(a) - b;
+    const bool negative = first != last && *first == '-';
+    UInt<N> magnitude;
+    const auto result = from_chars(first + negative, last, magnitude, base);
+    if(result.ec == std::errc::invalid_argument)
+        return {first, result.ec};
+    if(result.ec != std::errc())
+        return result;
+
+    // The magnitude can reach 2^(N-1) for a negative value, and stay below it for a positive one
+    const Int<N> v(magnitude);
+    if(v.is_negative() && !(negative && v == -v))
+        return {result.ptr, std::errc::result_out_of_range};
+
+    value = negative ? -v : v;
+    return result;
 }
 
 template<size_t N>
-template<size_t M>
-constexpr UInt<N>& UInt<N>::operator-=(const UInt<M>& a) noexcept
+std::ostream& operator<<(std::ostream& out, const Int<N>& n)
 {
-    uint64_t carry = 0;
-    for(size_t i = 0; i < ceil_div<32>(std::min(N, M)); ++i)
-    {
-        carry = data[i] - a.data[i] - carry;
-        data[i] = carry;
-        carry >>= 31;
-    }
-    truncate();
-
-    return *this;
+    if(n.is_negative())
+        out << '-';
+    return out << n.magnitude();
 }
 
+// Reads an optional '-' then the digits in the base of the stream, sets failbit when there are none or when the
+// value does not fit
 template<size_t N>
-constexpr UInt<N>& UInt<N>::operator-=(uint64_t a) noexcept
+std::istream& operator>>(std::istream& in, Int<N>& n)
 {
-    uint64_t carry = 0;
-    for(size_t i = 0; i < std::min(ceil_div<32>(N), static_cast<size_t>(2)); ++i)
+    std::istream::sentry sentry(in);
+    if(!sentry)
+        return in;
+
+    const bool negative = in.peek() == '-';
+    if(negative)
+        in.get();
+    UInt<N> magnitude;
+    in >> magnitude;
+    if(!in.fail())
     {
-        carry = data[i] - (a & 0xFFFFFFFF) - carry;
-        data[i] = carry;
-        carry >>= 31;
-        a >>= 32;
+        const Int<N> v(magnitude);
+        if(v.is_negative() && !(negative && v == -v))
+            in.setstate(std::ios::failbit);
+        else
+            n = negative ? -v : v;
     }
-    truncate();
 
-    return *this;
+    return in;
 }
 
+// Rounding of the digits that a fixed_decimal cannot keep
+enum class decimal_rounding
+{
+    toward_zero,
+    half_away_from_zero,
+    // Ties go to the even neighbour, which does not bias long sums
+    half_even
+};
 
-// *, *= operators
-template<size_t N, size_t M>
-constexpr auto operator*(const UInt<N>& a, const UInt<M>& b) noexcept
+// Decimal number with Scale digits after the point, held exactly as an Int<N> counting units of 10^-Scale.
+// Addition and subtraction are exact (they wrap on overflow like Int), multiplication and division round the
+// digits beyond Scale, half to even unless told otherwise
+template<size_t N, unsigned Scale>
+class fixed_decimal
 {
-    UInt<std::max(N, M)> total = 0;
+    public:
+        // 10^Scale, the raw value of 1
+        static constexpr UInt<N> unit = [] {
+            UInt<N> p = 1;
+            for(unsigned i = 0; i < Scale; ++i)
+                p *= 10u;
+            return p;
+        }();
+
+        // Constructors, from an integer value or from a count of units of 10^-Scale
+        constexpr fixed_decimal() noexcept = default;
+        constexpr fixed_decimal(int64_t a) noexcept : raw_{Int<N>(a) * Int<N>(unit)} {}
+        // Same value at another width, wrapped like Int when it does not fit
+        template<size_t M>
+        explicit constexpr fixed_decimal(const fixed_decimal<M, Scale>& a) noexcept : raw_{a.raw()} {}
+        static constexpr fixed_decimal from_raw(const Int<N>& raw) noexcept;
+
+        // Getters
+        constexpr const Int<N>& raw() const noexcept { return raw_; }
+        constexpr bool is_zero() const noexcept { return raw_.is_zero(); }
+        constexpr bool is_negative() const noexcept { return raw_.is_negative(); }
+        constexpr int sign() const noexcept { return raw_.sign(); }
+
+        // Arithmetic-assignement operators, the division by zero is undefined
+        constexpr fixed_decimal& operator+=(const fixed_decimal& a) noexcept { raw_ += a.raw_; return *this; }
+        constexpr fixed_decimal& operator-=(const fixed_decimal& a) noexcept { raw_ -= a.raw_; return *this; }
+        constexpr fixed_decimal& operator*=(const fixed_decimal& a) noexcept { return *this = mul(*this, a); }
+        constexpr fixed_decimal& operator/=(const fixed_decimal& a) noexcept { return *this = div(*this, a); }
+
+        // Product and quotient rounded to Scale digits, the exact result must fit in N bits
+        friend constexpr fixed_decimal mul(const fixed_decimal& a, const fixed_decimal& b,
+                                           decimal_rounding mode = decimal_rounding::half_even) noexcept
+        {
+            const auto qr = divmod(wide_mul(a.raw_.magnitude(), b.raw_.magnitude()), unit);
+            return from_magnitude(round(qr.first, qr.second, unit, mode), a.is_negative() != b.is_negative());
+        }
+        friend constexpr fixed_decimal div(const fixed_decimal& a, const fixed_decimal& b,
+                                           decimal_rounding mode = decimal_rounding::half_even) noexcept
+        {
+            const UInt<N> d = b.raw_.magnitude();
+            const auto qr = divmod(wide_mul(a.raw_.magnitude(), unit), d);
+            return from_magnitude(round(qr.first, qr.second, d, mode), a.is_negative() != b.is_negative());
+        }
+
+        // Operators
+        friend constexpr fixed_decimal operator-(const fixed_decimal& a) noexcept { return from_raw(-a.raw_); }
+        friend constexpr fixed_decimal operator+(fixed_decimal a, const fixed_decimal& b) noexcept { return a += b; }
+        friend constexpr fixed_decimal operator-(fixed_decimal a, const fixed_decimal& b) noexcept { return a -= b; }
+        friend constexpr fixed_decimal operator*(const fixed_decimal& a, const fixed_decimal& b) noexcept
+        {
+            return mul(a, b);
+        }
+        friend constexpr fixed_decimal operator/(const fixed_decimal& a, const fixed_decimal& b) noexcept
+        {
+            return div(a, b);
+        }
+
+        friend constexpr int compare(const fixed_decimal& a, const fixed_decimal& b) noexcept
+        {
+            return compare(a.raw_, b.raw_);
+        }
+        friend constexpr bool operator==(const fixed_decimal& a, const fixed_decimal& b) noexcept { return a.raw_ == b.raw_; }
+        friend constexpr bool operator!=(const fixed_decimal& a, const fixed_decimal& b) noexcept { return a.raw_ != b.raw_; }
+        friend constexpr bool operator<(const fixed_decimal& a, const fixed_decimal& b) noexcept { return a.raw_ < b.raw_; }
+        friend constexpr bool operator<=(const fixed_decimal& a, const fixed_decimal& b) noexcept { return a.raw_ <= b.raw_; }
+        friend constexpr bool operator>(const fixed_decimal& a, const fixed_decimal& b) noexcept { return a.raw_ > b.raw_; }
+        friend constexpr bool operator>=(const fixed_decimal& a, const fixed_decimal& b) noexcept { return a.raw_ >= b.raw_; }
+#ifdef UTILITIES_BIG_INT_THREE_WAY_COMPARISON
+        friend constexpr std::strong_ordering operator<=>(const fixed_decimal& a, const fixed_decimal& b) noexcept
+        {
+            return a.raw_ <=> b.raw_;
+        }
+#endif
 
-    for(size_t i = 0; i < ceil_div<32>(N); ++i)
-        for(size_t j = 0; j < ceil_div<32>(M); ++j)
-            total += (static_cast<uint64_t>(a.data[i]) * static_cast<uint64_t>(b.data[j])) << (32*i + 32*j);
+    private:
+        // Rounds the quotient q of a division by d that left the remainder r
+        template<size_t L, size_t M>
+        static constexpr UInt<N> round(const UInt<L>& q, const UInt<M>& r, const UInt<M>& d,
+                                       decimal_rounding mode) noexcept;
+        static constexpr fixed_decimal from_magnitude(const UInt<N>& m, bool negative) noexcept;
 
-    return total;
-}
+        Int<N> raw_;
 
-template<size_t N>
-constexpr auto operator*(const UInt<N>& a, uint64_t b) noexcept
+        // 10^Scale < 2^(10 * Scale / 3), a slightly stronger condition than fitting in the N - 1 value bits
+        static_assert(Scale * 10 / 3 + 1 < N, "10^Scale must fit in an Int<N>");
+};
+
+template<size_t N, unsigned Scale>
+constexpr fixed_decimal<N, Scale> fixed_decimal<N, Scale>::from_raw(const Int<N>& raw) noexcept
 {
-    return a * UInt<64>(b);
+    fixed_decimal result;
+    result.raw_ = raw;
+    return result;
 }
 
-template<size_t N>
-constexpr auto operator*(uint64_t a, const UInt<N>& b) noexcept
+template<size_t N, unsigned Scale>
+constexpr fixed_decimal<N, Scale> fixed_decimal<N, Scale>::from_magnitude(const UInt<N>& m, bool negative) noexcept
 {
-    return UInt<64>(a) * b;
+    const Int<N> raw(m);
+    return from_raw(negative ? -raw : raw);
 }
 
-template<size_t N>
-template<size_t M>
-constexpr UInt<N>& UInt<N>::operator*=(const UInt<M>& a) noexcept
+// 2r >= d is tested as r >= d - r, which cannot overflow since r < d
+template<size_t N, unsigned Scale>
+template<size_t L, size_t M>
+constexpr UInt<N> fixed_decimal<N, Scale>::round(const UInt<L>& q, const UInt<M>& r, const UInt<M>& d,
+                                                 decimal_rounding mode) noexcept
 {
-    *this = *this * a;
-    truncate();
+    UInt<N> result = q;
+    if(r == 0u || mode == decimal_rounding::toward_zero)
+        return result;
 
-    return *this;
+    const int half = compare(r, d - r);
+    if(half > 0 || (half == 0 && (mode == decimal_rounding::half_away_from_zero || (q & 1u) != 0u)))
+        result += 1u;
+
+    return result;
 }
 
-template<size_t N>
-constexpr UInt<N>& UInt<N>::operator*=(uint64_t a) noexcept
+
+// Sum of fixed_decimal<N, Scale> kept on 64 more bits than the terms, so that no realistic number of additions
+// overflows. The terms can be split between threads and the partial sums merged with += in any order, the total
+// being exact and independent of the split
+template<size_t N, unsigned Scale>
+class decimal_accumulator
+{
+    public:
+        using value_type = fixed_decimal<N + 64, Scale>;
+
+        constexpr decimal_accumulator() noexcept = default;
+
+        constexpr decimal_accumulator& operator+=(const fixed_decimal<N, Scale>& a) noexcept
+        {
+            bits_ += a.raw().bits();
+            negatives_ += a.is_negative();
+            return *this;
+        }
+        constexpr decimal_accumulator& operator-=(const fixed_decimal<N, Scale>& a) noexcept
+        {
+            bits_ -= a.raw().bits();
+            negatives_ -= a.is_negative();
+            return *this;
+        }
+        constexpr decimal_accumulator& operator+=(const decimal_accumulator& a) noexcept
+        {
+            bits_ += a.bits_;
+            negatives_ += a.negatives_;
+            return *this;
+        }
+
+        // For std::accumulate and std::reduce with an accumulator as initial value
+        friend constexpr decimal_accumulator operator+(decimal_accumulator a, const fixed_decimal<N, Scale>& b) noexcept
+        {
+            return a += b;
+        }
+        friend constexpr decimal_accumulator operator+(decimal_accumulator a, const decimal_accumulator& b) noexcept
+        {
+            return a += b;
+        }
+
+        constexpr value_type sum() const noexcept;
+
+    private:
+        // The terms are added without their sign extension, which is 2^N less for each negative term: the
+        // extensions are counted and taken off at the end rather than added one by one on the 64 extra bits
+        UInt<N + 64> bits_;
+        uint64_t negatives_ = 0;
+};
+
+template<size_t N, unsigned Scale>
+constexpr typename decimal_accumulator<N, Scale>::value_type decimal_accumulator<N, Scale>::sum() const noexcept
 {
-    return *this *= UInt<64>(a);
+    return value_type::from_raw(Int<N + 64>(bits_ - (UInt<N + 64>(negatives_) << N)));
 }
 
 
-template<size_t N>
-std::ostream& operator<<(std::ostream& out, const UInt<N>& n) noexcept
+// String conversions, in base 10 with a '.' before the Scale last digits
+template<size_t N, unsigned Scale>
+constexpr std::to_chars_result to_chars(char* first, char* last, const fixed_decimal<N, Scale>& value) noexcept
 {
-    auto flags = out.flags();
-    if(flags & std::ios::hex)
-        n.write_hex(out);
+    if(value.is_negative())
+    {
+        if(first == last)
+            return {last, std::errc::value_too_large};
+        *first++ = '-';
+    }
 
-    return out;
+    // The digits of the raw value are written once, then the last Scale ones are moved to make room for the point
+    const auto result = to_chars(first, last, value.raw().magnitude());
+    if(Scale == 0 || result.ec != std::errc())
+        return result;
 
-    out << n.data[ceil_div<32>(N)-1];
-    out.unsetf(std::ios_base::showbase | std::ios_base::showpos);
-    for(int i = ceil_div<32>(N)-2; i >= 0; --i)
-        out << n.data[i];
-    out.flags(flags);
+    const size_t count = result.ptr - first;
+    const size_t integral = count > Scale ? count - Scale : 1;
+    char* const end = first + integral + 1 + Scale;
+    if(last - first < static_cast<ptrdiff_t>(integral + 1 + Scale))
+        return {last, std::errc::value_too_large};
 
-    return out;
+    std::copy_backward(first + count - std::min<size_t>(count, Scale), result.ptr, end);
+    if(count <= Scale)
+        std::fill(first, end - count, '0');
+    first[integral] = '.';
+
+    return {end, std::errc()};
 }
 
-template<size_t N>
-void UInt<N>::write_hex(std::ostream& out) const noexcept
+// Reads an optional '-', the integral digits then optionally a '.' and at most Scale digits, the parsing stopping
+// before any further digit
+template<size_t N, unsigned Scale>
+constexpr std::from_chars_result from_chars(const char* first, const char* last, fixed_decimal<N, Scale>& value) noexcept
 {
-    auto flags = out.flags();
-    size_t i = ceil_div<32>(N);
-
-    bool zero = true;
-    while(zero && i-- > 0)
+    const bool negative = first != last && *first == '-';
+    UInt<N> integral;
+    auto result = from_chars(first + negative, last, integral);
+    if(result.ec == std::errc::invalid_argument)
+        return {first, result.ec};
+    if(result.ec != std::errc())
+        return result;
+
+    UInt<N> fraction;
+    unsigned digits = 0;
+    if(Scale != 0 && result.ptr + 1 < last && *result.ptr == '.' && result.ptr[1] >= '0' && result.ptr[1] <= '9')
     {
-        if(data[i] != 0)
-            zero = false;
+        ++result.ptr;
+        for(; digits < Scale && result.ptr != last && *result.ptr >= '0' && *result.ptr <= '9'; ++digits)
+            fraction = fraction * 10u + static_cast<uint64_t>(*result.ptr++ - '0');
+        for(unsigned i = digits; i < Scale; ++i)
+            fraction *= 10u;
     }
 
-    if(zero)
-    {
-        out << 0;
-        return;
-    }
+    // The magnitude can reach 2^(N-1) for a negative value, and stay below it for a positive one
+    const auto magnitude = wide_mul(integral, fixed_decimal<N, Scale>::unit) + fraction;
+    const size_t width = bit_width(magnitude);
+    if(width > N || (width == N && !(negative && countr_zero(magnitude) == N - 1)))
+        return {result.ptr, std::errc::result_out_of_range};
 
-    out << data[i];
-    out.unsetf(std::ios_base::showbase | std::ios_base::showpos);
+    const Int<N> raw{UInt<N>(magnitude)};
+    value = fixed_decimal<N, Scale>::from_raw(negative ? -raw : raw);
+    return result;
+}
 
-    while(i-- > 0)
+template<size_t N, unsigned Scale>
+std::ostream& operator<<(std::ostream& out, const fixed_decimal<N, Scale>& n)
+{
+    char buffer[N / 3 + Scale + 4];
+    return out << std::string_view(buffer, to_chars(buffer, buffer + sizeof(buffer), n).ptr - buffer);
+}
+
+
+// Arbitrary precision signed integer, in sign-magnitude form. The magnitude is kept in 64 bits limbs, least
+// significant first and without high zero limbs: up to inline_limbs of them inside the object, on the heap beyond.
+// The arithmetic runs the limb kernels of UInt and rounds like the built-in integers, the quotient toward zero.
+// The non-template members are defined in big_int.cpp
+class BigInt
+{
+    friend BigInt operator-(BigInt a) noexcept;
+    friend BigInt operator*(const BigInt& a, const BigInt& b);
+    friend std::pair<BigInt, BigInt> divmod(const BigInt& a, const BigInt& b);
+    friend std::from_chars_result from_chars(const char* first, const char* last, BigInt& value, int base);
+
+    public:
+        // Number of limbs stored without allocation
+        static constexpr size_t inline_limbs = 2;
+
+        // Constructors
+        BigInt() noexcept : size_{0}, capacity_{inline_limbs}, negative_{false}, inline_{} {}
+        template<typename T, typename = std::enable_if_t<std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t)>>
+        BigInt(T value) noexcept;
+        template<size_t N>
+        explicit BigInt(const UInt<N>& a);
+        BigInt(const BigInt& a);
+        BigInt(BigInt&& a) noexcept;
+        ~BigInt();
+
+        // Assignment operators
+        BigInt& operator=(const BigInt& a);
+        BigInt& operator=(BigInt&& a) noexcept;
+
+        // Arithmetic-assignement operators, dividing by zero throws std::domain_error
+        BigInt& operator+=(const BigInt& a);
+        BigInt& operator-=(const BigInt& a);
+        BigInt& operator*=(const BigInt& a);
+        BigInt& operator/=(const BigInt& a);
+        BigInt& operator%=(const BigInt& a);
+        // Shifts of the two's complement value, >> rounding toward minus infinity
+        BigInt& operator<<=(size_t n);
+        BigInt& operator>>=(size_t n);
+
+        // Getters
+        bool is_zero() const noexcept { return size_ == 0; }
+        bool is_negative() const noexcept { return negative_; }
+        // -1, 0 or 1
+        int sign() const noexcept { return negative_ ? -1 : size_ != 0; }
+        // Limbs of the magnitude, size() of them
+        size_t size() const noexcept { return size_; }
+        const uint64_t* limbs() const noexcept { return capacity_ > inline_limbs ? heap_ : inline_; }
+
+        // Conversions, to_uint wraps the two's complement value modulo 2^N like the conversions between integers
+        explicit operator bool() const noexcept { return size_ != 0; }
+        template<size_t N>
+        UInt<N> to_uint() const noexcept;
+
+    private:
+        uint64_t* mutable_limbs() noexcept { return capacity_ > inline_limbs ? heap_ : inline_; }
+        // Makes room for n limbs, keeping the current ones
+        void reserve(size_t n);
+        // Drops the high zero limbs, and the sign of zero
+        void normalize() noexcept;
+        // *this += |a| with the given sign, shared by += and -=
+        void add_signed(const BigInt& a, bool negative);
+
+        size_t size_;
+        size_t capacity_;
+        bool negative_;
+        union
+        {
+            uint64_t inline_[inline_limbs];
+            uint64_t* heap_;
+        };
+};
+
+// Constructors
+template<typename T, typename>
+BigInt::BigInt(T value) noexcept : BigInt()
+{
+    if constexpr(std::is_signed_v<T>)
     {
-        out << std::setw(8) << std::setfill('0') << std::right << data[i];
+        negative_ = value < 0;
+        inline_[0] = negative_ ? ~static_cast<uint64_t>(value) + 1 : static_cast<uint64_t>(value);
     }
-
-    out.flags(flags);
+    else
+        inline_[0] = static_cast<uint64_t>(value);
+    size_ = inline_[0] != 0;
 }
 
+template<size_t N>
+BigInt::BigInt(const UInt<N>& a) : BigInt()
+{
+    const size_t n = implementation_detail::significant(a.data, UInt<N>::limb_count);
+    reserve(n);
+    implementation_detail::copy(mutable_limbs(), a.data, n);
+    size_ = n;
+}
 
+// Conversions
 template<size_t N>
-inline constexpr void UInt<N>::truncate() noexcept
+UInt<N> BigInt::to_uint() const noexcept
 {
-    if constexpr(N % 32 != 0)
-        data[ceil_div<32>(N) - 1] %= (1 << (N % 32));
+    UInt<N> result;
+    implementation_detail::copy(result.data, limbs(), std::min(size_, UInt<N>::limb_count));
+    if(negative_)
+        implementation_detail::neg(result.data, result.data, UInt<N>::limb_count);
+    result.truncate();
+
+    return result;
 }
 
+// Arithmetic operators
+BigInt operator-(BigInt a) noexcept;
+BigInt operator+(const BigInt& a, const BigInt& b);
+BigInt operator-(const BigInt& a, const BigInt& b);
+BigInt operator*(const BigInt& a, const BigInt& b);
+BigInt operator/(const BigInt& a, const BigInt& b);
+BigInt operator%(const BigInt& a, const BigInt& b);
+BigInt operator<<(const BigInt& a, size_t n);
+BigInt operator>>(const BigInt& a, size_t n);
+
+// Quotient truncated toward zero and remainder of the sign of a, b must not be zero
+std::pair<BigInt, BigInt> divmod(const BigInt& a, const BigInt& b);
+
+// Comparison operators
+// -1, 0 or 1 as a is below, equal to or above b
+int compare(const BigInt& a, const BigInt& b) noexcept;
+
+inline bool operator==(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) == 0; }
+inline bool operator!=(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) != 0; }
+inline bool operator<(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) < 0; }
+inline bool operator<=(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) <= 0; }
+inline bool operator>(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) > 0; }
+inline bool operator>=(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) >= 0; }
+#ifdef UTILITIES_BIG_INT_THREE_WAY_COMPARISON
+inline std::strong_ordering operator<=>(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) <=> 0; }
+#endif
+
+// String conversions, with a leading '-' for the negative values
+std::to_chars_result to_chars(char* first, char* last, const BigInt& value, int base = 10);
+std::from_chars_result from_chars(const char* first, const char* last, BigInt& value, int base = 10);
+
+std::ostream& operator<<(std::ostream& out, const BigInt& n);
+std::istream& operator>>(std::istream& in, BigInt& n);
+
 
 
 
@@ -0,0 +1,379 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+#ifndef UTILITIES_BIG_INT_BATCH_HPP
+#define UTILITIES_BIG_INT_BATCH_HPP
+
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include "big_int.hpp"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+
+namespace implementation_detail
+{
+    // Lanes of 64 bits processed together by the batch kernels, one value of the batch per lane. Carries are
+    // vectors of 0 or 1
+#if defined(__AVX512F__)
+    struct batch_lanes
+    {
+        using type = __m512i;
+        static constexpr size_t width = 8;
+
+        static type load(const uint64_t* p) noexcept { return _mm512_load_si512(p); }
+        static void store(uint64_t* p, type x) noexcept { _mm512_store_si512(p, x); }
+        static type set1(uint64_t x) noexcept { return _mm512_set1_epi64(static_cast<long long>(x)); }
+        static type add(type a, type b) noexcept { return _mm512_add_epi64(a, b); }
+        static type sub(type a, type b) noexcept { return _mm512_sub_epi64(a, b); }
+        static type bit_and(type a, type b) noexcept { return _mm512_and_si512(a, b); }
+        static type bit_or(type a, type b) noexcept { return _mm512_or_si512(a, b); }
+        static type shift_left32(type a) noexcept { return _mm512_slli_epi64(a, 32); }
+        static type shift_right32(type a) noexcept { return _mm512_srli_epi64(a, 32); }
+        // Product of the low 32 bits of the lanes
+        static type mul32(type a, type b) noexcept { return _mm512_mul_epu32(a, b); }
+        // 1 where a < b
+        static type less(type a, type b) noexcept { return _mm512_maskz_set1_epi64(_mm512_cmplt_epu64_mask(a, b), 1); }
+    };
+#elif defined(__AVX2__)
+    struct batch_lanes
+    {
+        using type = __m256i;
+        static constexpr size_t width = 4;
+
+        static type load(const uint64_t* p) noexcept { return _mm256_load_si256(reinterpret_cast<const type*>(p)); }
+        static void store(uint64_t* p, type x) noexcept { _mm256_store_si256(reinterpret_cast<type*>(p), x); }
+        static type set1(uint64_t x) noexcept { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+        static type add(type a, type b) noexcept { return _mm256_add_epi64(a, b); }
+        static type sub(type a, type b) noexcept { return _mm256_sub_epi64(a, b); }
+        static type bit_and(type a, type b) noexcept { return _mm256_and_si256(a, b); }
+        static type bit_or(type a, type b) noexcept { return _mm256_or_si256(a, b); }
+        static type shift_left32(type a) noexcept { return _mm256_slli_epi64(a, 32); }
+        static type shift_right32(type a) noexcept { return _mm256_srli_epi64(a, 32); }
+        static type mul32(type a, type b) noexcept { return _mm256_mul_epu32(a, b); }
+        // AVX2 only compares signed lanes, flipping the sign bits turns it into the unsigned comparison
+        static type less(type a, type b) noexcept
+        {
+            const type sign = set1(uint64_t(1) << 63);
+            return _mm256_srli_epi64(_mm256_cmpgt_epi64(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign)), 63);
+        }
+    };
+#endif
+
+    // r = a + b on rows of stride values, limb j of value i at j * stride + i, count being a multiple of the
+    // number of lanes. r may be equal to a or b
+    template<size_t n>
+    void batch_add(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t stride, size_t count,
+                   uint64_t top_mask) noexcept
+    {
+#if defined(__AVX2__) || defined(__AVX512F__)
+        using V = batch_lanes;
+        for(size_t i = 0; i < count; i += V::width)
+        {
+            auto carry = V::set1(0);
+            for(size_t j = 0; j < n; ++j)
+            {
+                const auto x = V::load(a + j * stride + i);
+                const auto s = V::add(x, V::load(b + j * stride + i));
+                const auto t = V::add(s, carry);
+                carry = V::bit_or(V::less(s, x), V::less(t, s));
+                V::store(r + j * stride + i, j + 1 < n ? t : V::bit_and(t, V::set1(top_mask)));
+            }
+        }
+#else
+        for(size_t i = 0; i < count; ++i)
+        {
+            uint64_t carry = 0;
+            for(size_t j = 0; j < n; ++j)
+                r[j * stride + i] = add_carry(a[j * stride + i], b[j * stride + i], carry);
+            r[(n - 1) * stride + i] &= top_mask;
+        }
+#endif
+    }
+
+    // r = a - b, same layout as batch_add
+    template<size_t n>
+    void batch_sub(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t stride, size_t count,
+                   uint64_t top_mask) noexcept
+    {
+#if defined(__AVX2__) || defined(__AVX512F__)
+        using V = batch_lanes;
+        for(size_t i = 0; i < count; i += V::width)
+        {
+            auto borrow = V::set1(0);
+            for(size_t j = 0; j < n; ++j)
+            {
+                const auto x = V::load(a + j * stride + i);
+                const auto y = V::load(b + j * stride + i);
+                const auto d = V::sub(x, y);
+                const auto t = V::sub(d, borrow);
+                borrow = V::bit_or(V::less(x, y), V::less(d, borrow));
+                V::store(r + j * stride + i, j + 1 < n ? t : V::bit_and(t, V::set1(top_mask)));
+            }
+        }
+#else
+        for(size_t i = 0; i < count; ++i)
+        {
+            uint64_t borrow = 0;
+            for(size_t j = 0; j < n; ++j)
+                r[j * stride + i] = sub_borrow(a[j * stride + i], b[j * stride + i], borrow);
+            r[(n - 1) * stride + i] &= top_mask;
+        }
+#endif
+    }
+
+    // r = the n low limbs of a * b, same layout as batch_add
+    template<size_t n>
+    void batch_mul(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t stride, size_t count,
+                   uint64_t top_mask) noexcept
+    {
+#if defined(__AVX2__) || defined(__AVX512F__)
+        // The lanes only multiply 32 by 32 bits, so the product is a schoolbook one on 32 bits digits. The low and
+        // high halves of every digit product are accumulated in separate columns, which cannot overflow 64 bits,
+        // and the carries are propagated once at the end
+        using V = batch_lanes;
+        constexpr size_t digits = 2 * n;
+        const auto low = V::set1(0xFFFFFFFF);
+        for(size_t i = 0; i < count; i += V::width)
+        {
+            typename V::type x[digits], y[digits], column[digits];
+            for(size_t j = 0; j < n; ++j)
+            {
+                x[2*j] = V::load(a + j * stride + i);
+                x[2*j + 1] = V::shift_right32(x[2*j]);
+                y[2*j] = V::load(b + j * stride + i);
+                y[2*j + 1] = V::shift_right32(y[2*j]);
+            }
+            for(size_t k = 0; k < digits; ++k)
+                column[k] = V::set1(0);
+
+            for(size_t k = 0; k < digits; ++k)
+            {
+                for(size_t l = 0; k + l < digits; ++l)
+                {
+                    const auto p = V::mul32(x[k], y[l]);
+                    column[k + l] = V::add(column[k + l], V::bit_and(p, low));
+                    if(k + l + 1 < digits)
+                        column[k + l + 1] = V::add(column[k + l + 1], V::shift_right32(p));
+                }
+            }
+
+            auto carry = V::set1(0);
+            for(size_t j = 0; j < n; ++j)
+            {
+                const auto even = V::add(column[2*j], carry);
+                const auto odd = V::add(column[2*j + 1], V::shift_right32(even));
+                carry = V::shift_right32(odd);
+                const auto limb = V::bit_or(V::bit_and(even, low), V::shift_left32(odd));
+                V::store(r + j * stride + i, j + 1 < n ? limb : V::bit_and(limb, V::set1(top_mask)));
+            }
+        }
+#else
+        for(size_t i = 0; i < count; ++i)
+        {
+            uint64_t x[n], y[n], z[n];
+            for(size_t j = 0; j < n; ++j)
+            {
+                x[j] = a[j * stride + i];
+                y[j] = b[j * stride + i];
+            }
+            mul_low(z, x, n, y, n, n);
+            for(size_t j = 0; j < n; ++j)
+                r[j * stride + i] = z[j];
+            r[(n - 1) * stride + i] &= top_mask;
+        }
+#endif
+    }
+}
+
+
+// Array of UInt<N> stored limb-sliced (structure of arrays): row j holds limb j of every value, so that the
+// arithmetic runs one value per SIMD lane (AVX2 or AVX-512 when enabled at compile time), the carries moving from
+// row to row. Rows are padded to a multiple of lanes values and start on alignment-byte boundaries
+template<size_t N>
+class UIntBatch
+{
+    public:
+        static constexpr size_t limb_count = UInt<N>::limb_count;
+        static constexpr size_t lanes = 8;
+        static constexpr size_t alignment = 64;
+
+        // Constructors, the values are zero
+        UIntBatch() noexcept : count_{0}, stride_{0}, data_{nullptr} {}
+        explicit UIntBatch(size_t count);
+        UIntBatch(const UInt<N>* values, size_t count);
+        UIntBatch(const UIntBatch& a);
+        UIntBatch(UIntBatch&& a) noexcept = default;
+        ~UIntBatch() = default;
+
+        // move & copy assigment
+        UIntBatch& operator=(const UIntBatch& a);
+        UIntBatch& operator=(UIntBatch&& a) noexcept = default;
+
+        // Conversions from and to the array of UInt layout
+        void load(const UInt<N>* values, size_t count);
+        void store(UInt<N>* values) const noexcept;
+        UInt<N> get(size_t i) const;
+        void set(size_t i, const UInt<N>& value);
+
+        // Arithmetic-assignement operators, value by value modulo 2^N, both batches must have the same size
+        UIntBatch& operator+=(const UIntBatch& a);
+        UIntBatch& operator-=(const UIntBatch& a);
+        UIntBatch& operator*=(const UIntBatch& a);
+
+        // getters
+        size_t size() const noexcept { return count_; }
+        bool empty() const noexcept { return count_ == 0; }
+        // Limb j of every value, size() of them
+        const uint64_t* row(size_t j) const noexcept { return data_.get() + j * stride_; }
+
+    private:
+        struct aligned_delete
+        {
+            void operator()(uint64_t* p) const noexcept { ::operator delete[](p, std::align_val_t{alignment}); }
+        };
+
+        static constexpr uint64_t top_mask = N % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (N % 64)) - 1;
+
+        void check_size(const UIntBatch& a) const
+        {
+            if(a.count_ != count_)
+                throw std::invalid_argument("");
+        }
+
+        size_t count_;
+        size_t stride_;
+        std::unique_ptr<uint64_t[], aligned_delete> data_;
+};
+
+// Constructors
+template<size_t N>
+UIntBatch<N>::UIntBatch(size_t count) :
+    count_{count},
+    stride_{(count + lanes - 1) / lanes * lanes},
+    data_{static_cast<uint64_t*>(::operator new[](stride_ * limb_count * sizeof(uint64_t),
+                                                  std::align_val_t{alignment}))}
+{
+    implementation_detail::zero(data_.get(), stride_ * limb_count);
+}
+
+template<size_t N>
+UIntBatch<N>::UIntBatch(const UInt<N>* values, size_t count) : UIntBatch(count)
+{
+    load(values, count);
+}
+
+template<size_t N>
+UIntBatch<N>::UIntBatch(const UIntBatch& a) : UIntBatch(a.count_)
+{
+    implementation_detail::copy(data_.get(), a.data_.get(), stride_ * limb_count);
+}
+
+template<size_t N>
+UIntBatch<N>& UIntBatch<N>::operator=(const UIntBatch& a)
+{
+    if(this != &a)
+        *this = UIntBatch(a);
+
+    return *this;
+}
+
+// Conversions
+template<size_t N>
+void UIntBatch<N>::load(const UInt<N>* values, size_t count)
+{
+    if(count != count_)
+        *this = UIntBatch(count);
+
+    for(size_t i = 0; i < count_; ++i)
+        for(size_t j = 0; j < limb_count; ++j)
+            data_[j * stride_ + i] = values[i].data[j];
+}
+
+template<size_t N>
+void UIntBatch<N>::store(UInt<N>* values) const noexcept
+{
+    for(size_t i = 0; i < count_; ++i)
+        for(size_t j = 0; j < limb_count; ++j)
+            values[i].data[j] = data_[j * stride_ + i];
+}
+
+template<size_t N>
+UInt<N> UIntBatch<N>::get(size_t i) const
+{
+    if(i >= count_)
+        throw std::out_of_range("");
+
+    UInt<N> value;
+    for(size_t j = 0; j < limb_count; ++j)
+        value.data[j] = data_[j * stride_ + i];
+
+    return value;
+}
+
+template<size_t N>
+void UIntBatch<N>::set(size_t i, const UInt<N>& value)
+{
+    if(i >= count_)
+        throw std::out_of_range("");
+
+    for(size_t j = 0; j < limb_count; ++j)
+        data_[j * stride_ + i] = value.data[j];
+}
+
+// Arithmetic-assignement operators
+template<size_t N>
+UIntBatch<N>& UIntBatch<N>::operator+=(const UIntBatch& a)
+{
+    check_size(a);
+    implementation_detail::batch_add<limb_count>(data_.get(), data_.get(), a.data_.get(), stride_, stride_, top_mask);
+
+    return *this;
+}
+
+template<size_t N>
+UIntBatch<N>& UIntBatch<N>::operator-=(const UIntBatch& a)
+{
+    check_size(a);
+    implementation_detail::batch_sub<limb_count>(data_.get(), data_.get(), a.data_.get(), stride_, stride_, top_mask);
+
+    return *this;
+}
+
+template<size_t N>
+UIntBatch<N>& UIntBatch<N>::operator*=(const UIntBatch& a)
+{
+    check_size(a);
+    implementation_detail::batch_mul<limb_count>(data_.get(), data_.get(), a.data_.get(), stride_, stride_, top_mask);
+
+    return *this;
+}
+
+// Arithmetic operators
+template<size_t N>
+UIntBatch<N> operator+(UIntBatch<N> a, const UIntBatch<N>& b)
+{
+    a += b;
+    return a;
+}
+
+template<size_t N>
+UIntBatch<N> operator-(UIntBatch<N> a, const UIntBatch<N>& b)
+{
+    a -= b;
+    return a;
+}
+
+template<size_t N>
+UIntBatch<N> operator*(UIntBatch<N> a, const UIntBatch<N>& b)
+{
+    a *= b;
+    return a;
+}
+
+
+#endif //UTILITIES_BIG_INT_BATCH_HPP
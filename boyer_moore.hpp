@@ -8,28 +8,70 @@
 #include <type_traits>
 #include <algorithm>
 #include <functional>
+#include <future>
+#include <thread>
+#include <array>
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstddef>
+
+// The byte searcher filters candidate positions with vector compares on x86
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#define UTILITIES_BOYER_MOORE_SIMD
+#endif
 
 
 template<typename Iter>
 class BoyerMoore
 {
     public:
+        using value_type = typename std::iterator_traits<Iter>::value_type;
+
+        // Number of starting positions below which find_all does not give a chunk to another thread
+        static constexpr size_t min_chunk_size = size_t(1) << 16;
+
         // Setup the data required
         BoyerMoore(Iter first, Iter last);
 
         // Apply the algorithm / search in a sequence
         template<typename Iter2>
         Iter2 operator()(Iter2 first, Iter2 last) const;
-    
-    private:
+
+        // Calls f(it) on every match in a sequence, in order (overlapping ones included)
+        template<typename Iter2, typename F>
+        void for_each_match(Iter2 first, Iter2 last, F&& f) const;
+
+        // Every match in a sequence, in order (overlapping ones included). The sequence is cut in chunks searched
+        // on up to threads threads, each chunk running pattern length - 1 elements into the next one so that a
+        // match across a boundary is found exactly once
         template<typename Iter2>
-        Iter2 next_valid_pos(Iter2 first, Iter2 last, Iter2 s_first, Iter2 s_last) const;
-    
+        std::vector<Iter2> find_all(Iter2 first, Iter2 last,
+                                    size_t threads = std::thread::hardware_concurrency()) const;
+
+    private:
+        // The bad element table is a flat array of 256 shifts for the byte-sized elements, a hash table for the
+        // other hashable ones and a std::map for the rest
+        static constexpr bool flat_table = sizeof(value_type) == 1 &&
+                                           (std::is_integral_v<value_type> || std::is_enum_v<value_type>);
+        using table_type = std::conditional_t<flat_table, std::array<size_t, 256>,
+                               std::conditional_t<std::is_default_constructible_v<std::hash<value_type>>,
+                                                  std::unordered_map<value_type, size_t>,
+                                                  std::map<value_type, size_t>>>;
+
+        // Shift when the last element of the window is x and mismatches
+        template<typename T>
+        size_t bad_shift(const T& x) const;
+
         Iter first_;
         Iter last_;
-        std::map<typename Iter::value_type, size_t> first_table;
+        // Shift when the last element of the window mismatches, by value of that element
+        table_type first_table;
+        // Shift when k > 0 elements matched before a mismatch, second_table[length - 1] after a complete match
         std::vector<size_t> second_table;
 };
 
@@ -42,94 +84,375 @@ BoyerMoore<Iter>::BoyerMoore(Iter first, Iter last) :
 {
     static_assert(std::is_same_v<
                       typename  std::iterator_traits<Iter>::iterator_category,
-                      std::random_access_iterator_tag>, 
+                      std::random_access_iterator_tag>,
                   "Only random access iterator are supported");
-    
-    if(first_ == last_)
+
+    const size_t length = last_ - first_;
+    if(length == 0)
         return;
-    
-    auto it = last_ - 2;
-    size_t i = 1;
-    
-    while(it >= first_)
+
+    // The last occurrence before the last element wins
+    if constexpr(flat_table)
     {
-        if(first_table.find(*it) == first_table.end())
-            first_table.insert({*it, i});
-        ++i;
-        --it;
+        first_table.fill(length);
+        for(size_t i = 0; i + 1 < length; ++i)
+            first_table[static_cast<unsigned char>(first_[i])] = length - 1 - i;
     }
+    else
+        for(size_t i = 0; i + 1 < length; ++i)
+            first_table[first_[i]] = length - 1 - i;
 
-    auto rfirst = std::reverse_iterator(last_);
-    auto rlast = std::reverse_iterator(first_);
-    
-    second_table[0] = 1;
-    for(auto rit = rfirst + 1; rit != rlast; ++rit)
+    // suffix[i] is the length of the longest common suffix of the pattern and of the pattern cut after i, in linear
+    // time: [g, f] is the rightmost known segment matching a suffix of the pattern, and inside it suffix[i] is read
+    // from the position it mirrors unless that suffix reaches past g
+    std::vector<size_t> suffix(length);
+    suffix[length - 1] = length;
+    const auto m = static_cast<std::ptrdiff_t>(length);
+    for(std::ptrdiff_t i = m - 2, f = m - 1, g = m - 1; i >= 0; --i)
     {
-        auto pos = next_valid_pos(rfirst + 1, rlast, rfirst, rit);
-        second_table[rit-rfirst] = pos - rfirst;
+        if(i > g && static_cast<std::ptrdiff_t>(suffix[i + m - 1 - f]) < i - g)
+            suffix[i] = suffix[i + m - 1 - f];
+        else
+        {
+            g = std::min(g, i);
+            f = i;
+            while(g >= 0 && first_[g] == first_[g + m - 1 - f])
+                --g;
+            suffix[i] = static_cast<size_t>(f - g);
+        }
     }
+
+    // shift[j] when the element at j mismatches: the matched suffix reappears further left in the pattern, or a
+    // prefix of the pattern is a suffix of it
+    std::vector<size_t> shift(length, length);
+    for(size_t i = length, j = 0; i-- > 0;)
+        if(suffix[i] == i + 1)
+            for(; j < length - 1 - i; ++j)
+                if(shift[j] == length)
+                    shift[j] = length - 1 - i;
+    for(size_t i = 0; i + 1 < length; ++i)
+        shift[length - 1 - suffix[i]] = length - 1 - i;
+
+    for(size_t k = 0; k < length; ++k)
+        second_table[k] = shift[length - 1 - k];
 }
 
 
 template<typename Iter>
 template<typename Iter2>
-Iter2 BoyerMoore<Iter>::next_valid_pos(Iter2 first, Iter2 last, Iter2 s_first, Iter2 s_last) const
+Iter2 BoyerMoore<Iter>::operator()(Iter2 first, Iter2 last) const
 {
-    for (; ; ++first) {
-        auto it = first;
-        for (auto s_it = s_first; ; ++it, ++s_it) {
-            if (it == last) {
-                return last - (s_it - s_first);
-            }
-            if (s_it == s_last) {
-                if(!(*(s_it+1) == *(it+1)))
-                    break;
-                return first;
-            }
-            if (!(*it == *s_it)) {
-                break;
-            }
+    static_assert(std::is_same_v<
+                     typename  std::iterator_traits<Iter2>::iterator_category,
+                     std::random_access_iterator_tag>,
+                 "Only random access iterator are supported");
+
+    const auto length = last_-first_;
+    if(length == 0)
+        return first;
+
+    while(last - first >= length)
+    {
+        // Last element mismatch
+        const auto& last_elem = *(first + (length - 1));
+        if(!(*(last_-1) == last_elem))
+        {
+            first += bad_shift(last_elem);
+            continue;
         }
+
+        // The rest is compared from right to left, s_it ending on the leftmost matched element
+        auto s_it = last_-1;
+        for(auto it = first + (length - 1); s_it != first_ && *(it-1) == *(s_it-1); --s_it, --it);
+
+        // A complete match is found
+        if(s_it == first_)
+            return first;
+
+        first += second_table[last_ - s_it];
     }
+
+    return last;
+}
+
+
+template<typename Iter>
+template<typename T>
+size_t BoyerMoore<Iter>::bad_shift(const T& x) const
+{
+    // An element of another type is truncated to a byte, which can only shorten the shift
+    if constexpr(flat_table)
+        return first_table[static_cast<unsigned char>(x)];
+    else
+    {
+        const auto pos = first_table.find(x);
+        return pos == first_table.end() ? static_cast<size_t>(last_ - first_) : pos->second;
+    }
+}
+
+
+template<typename Iter>
+template<typename Iter2, typename F>
+void BoyerMoore<Iter>::for_each_match(Iter2 first, Iter2 last, F&& f) const
+{
+    if(first_ == last_)
+        return;
+
+    // After a match, the window can move by the period of the pattern without missing an overlapping one
+    for(auto it = (*this)(first, last); it != last; it = (*this)(it + second_table.back(), last))
+        f(it);
 }
 
 
 template<typename Iter>
 template<typename Iter2>
-Iter2 BoyerMoore<Iter>::operator()(Iter2 first, Iter2 last) const
-{  
+std::vector<Iter2> BoyerMoore<Iter>::find_all(Iter2 first, Iter2 last, size_t threads) const
+{
     static_assert(std::is_same_v<
                      typename  std::iterator_traits<Iter2>::iterator_category,
                      std::random_access_iterator_tag>,
                  "Only random access iterator are supported");
-    
-    const auto length = last_-first_;
-    
-    while(first < last - length)
+
+    std::vector<Iter2> matches;
+    const size_t length = last_ - first_;
+    if(length == 0 || static_cast<size_t>(last - first) < length)
+        return matches;
+
+    // The starting positions are split evenly, chunk i searching from starts i up to the first start of chunk
+    // i + 1 plus length - 1 elements, so the matches of a chunk all start in it
+    const size_t starts = (last - first) - length + 1;
+    const size_t chunks = std::max<size_t>(1, std::min(threads, starts / min_chunk_size));
+    const auto start = [&](size_t i) { return first + (starts / chunks * i + std::min(i, starts % chunks)); };
+
+    // The first chunk is searched by this thread while the others run
+    std::vector<std::future<std::vector<Iter2>>> results;
+    for(size_t i = 1; i < chunks; ++i)
+        results.push_back(std::async(std::launch::async, [this, from = start(i), to = start(i + 1) + (length - 1)] {
+            std::vector<Iter2> m;
+            for_each_match(from, to, [&m](Iter2 it) { m.push_back(it); });
+            return m;
+        }));
+    for_each_match(first, start(1) + (length - 1), [&matches](Iter2 it) { matches.push_back(it); });
+
+    for(auto& r : results)
     {
-        // First element mismatch
-        auto first_elem = *(first + length - 1);
-        if(!(*(last_-1) == first_elem))
+        const auto m = r.get();
+        matches.insert(matches.end(), m.begin(), m.end());
+    }
+
+    return matches;
+}
+
+// Searches a stream arriving in chunks, reporting the offset in the whole stream of every match (overlapping ones
+// included). Only the last pattern length - 1 elements seen are kept from one chunk to the next, to find the
+// matches across the boundary
+template<typename Iter>
+class StreamSearcher
+{
+    public:
+        using value_type = typename std::iterator_traits<Iter>::value_type;
+
+        // Setup the data required
+        StreamSearcher(Iter first, Iter last);
+
+        // Searches the next chunk, callback(offset) being called in order for every match ending in it
+        template<typename Iter2, typename Callback>
+        void operator()(Iter2 first, Iter2 last, Callback&& callback);
+
+        // Number of elements fed so far
+        size_t position() const noexcept { return position_; }
+
+        // Starts a new stream
+        void reset() noexcept;
+
+    private:
+        BoyerMoore<Iter> searcher_;
+        size_t length_;
+        // Last elements of the stream, at most length_ - 1 of them
+        std::vector<value_type> tail_;
+        size_t position_ = 0;
+};
+
+
+template<typename Iter>
+StreamSearcher<Iter>::StreamSearcher(Iter first, Iter last) :
+    searcher_{first, last},
+    length_(last - first)
+{
+    tail_.reserve(2 * length_);
+}
+
+
+template<typename Iter>
+template<typename Iter2, typename Callback>
+void StreamSearcher<Iter>::operator()(Iter2 first, Iter2 last, Callback&& callback)
+{
+    const size_t size = last - first;
+    if(length_ == 0)
+    {
+        position_ += size;
+        return;
+    }
+
+    // A match across the boundary starts in the tail and takes less than length_ elements from the chunk, and the
+    // joined elements are too short to hold a match starting in the chunk
+    const size_t kept = tail_.size();
+    tail_.insert(tail_.end(), first, first + std::min(size, length_ - 1));
+    if(kept != 0)
+        searcher_.for_each_match(tail_.cbegin(), tail_.cend(), [&](auto it) {
+            callback(position_ - kept + (it - tail_.cbegin()));
+        });
+
+    searcher_.for_each_match(first, last, [&](Iter2 it) { callback(position_ + (it - first)); });
+    position_ += size;
+
+    // The joined elements hold the new tail unless the chunk is long enough to provide it alone
+    if(size >= length_ - 1)
+        tail_.assign(last - (length_ - 1), last);
+    else
+        tail_.erase(tail_.begin(), tail_.end() - std::min(tail_.size(), length_ - 1));
+}
+
+
+template<typename Iter>
+void StreamSearcher<Iter>::reset() noexcept
+{
+    tail_.clear();
+    position_ = 0;
+}
+
+
+
+namespace implementation_detail
+{
+    // Elements that can be compared as single bytes
+    template<typename T>
+    constexpr bool is_byte_like = sizeof(T) == 1 && (std::is_integral_v<T> || std::is_enum_v<T>);
+
+    // Iterators known to walk over contiguous memory, so that their elements can be loaded in vectors
+    template<typename It>
+    constexpr bool is_contiguous_iterator = []
+    {
+        using value_type = std::remove_const_t<typename std::iterator_traits<It>::value_type>;
+        if constexpr(std::is_pointer_v<It>)
+            return true;
+        else if constexpr(std::is_same_v<value_type, char>)
+            return std::is_same_v<It, std::string::iterator> || std::is_same_v<It, std::string::const_iterator> ||
+                   std::is_same_v<It, std::string_view::const_iterator> ||
+                   std::is_same_v<It, typename std::vector<char>::iterator> ||
+                   std::is_same_v<It, typename std::vector<char>::const_iterator>;
+        else if constexpr(!std::is_same_v<value_type, bool>)
+            return std::is_same_v<It, typename std::vector<value_type>::iterator> ||
+                   std::is_same_v<It, typename std::vector<value_type>::const_iterator>;
+        else
+            return false;
+    }();
+
+#ifdef UTILITIES_BOYER_MOORE_SIMD
+    // Position of the first occurrence of p[0..m) in h[0..n), n when there is none, with 0 < m <= n. The candidate
+    // positions are filtered a vector at a time on their first and last bytes, only the survivors being compared
+    inline size_t simd_search(const unsigned char* h, size_t n, const unsigned char* p, size_t m) noexcept
+    {
+        const size_t middle = m > 2 ? m - 2 : 0;
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256i first = _mm256_set1_epi8(static_cast<char>(p[0]));
+        const __m256i last = _mm256_set1_epi8(static_cast<char>(p[m-1]));
+        for(; i + m + 31 <= n; i += 32)
         {
-            auto pos = first_table.find(first_elem);
-            first += (pos == first_table.end() ? length : first_table.at(first_elem));
-            continue;
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + m - 1));
+            auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+            for(; mask != 0; mask &= mask - 1)
+            {
+                const size_t k = i + static_cast<size_t>(__builtin_ctz(mask));
+                if(std::memcmp(h + k + 1, p + 1, middle) == 0)
+                    return k;
+            }
         }
-        auto s_it = last_-2;
-        for(auto it = first + length - 2; ; --s_it, --it)
+#else
+        const __m128i first = _mm_set1_epi8(static_cast<char>(p[0]));
+        const __m128i last = _mm_set1_epi8(static_cast<char>(p[m-1]));
+        for(; i + m + 15 <= n; i += 16)
         {
-            // A mismatch is found
-            if(!(*it == *s_it))
-                break;
-            // A complete match is found
-            if(s_it == first_)
-                return first;
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + m - 1));
+            auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+            for(; mask != 0; mask &= mask - 1)
+            {
+                const size_t k = i + static_cast<size_t>(__builtin_ctz(mask));
+                if(std::memcmp(h + k + 1, p + 1, middle) == 0)
+                    return k;
+            }
         }
-        
-        first += second_table[last_-1 - s_it];
+#endif
+        // Fewer positions left than a vector holds
+        for(; i + m <= n; ++i)
+            if(h[i] == p[0] && h[i + m - 1] == p[m-1] && std::memcmp(h + i + 1, p + 1, middle) == 0)
+                return i;
+
+        return n;
     }
-    
-    return last;
+#endif
+}
+
+
+// Same interface as BoyerMoore. A byte pattern searched in contiguous bytes goes through a vectorized filter on the
+// first and last bytes of the pattern, which beats the skips of Boyer-Moore for short patterns; any other
+// search is left to BoyerMoore
+template<typename Iter>
+class SimdSearcher
+{
+    public:
+        using value_type = typename std::iterator_traits<Iter>::value_type;
+
+        // Setup the data required
+        SimdSearcher(Iter first, Iter last);
+
+        // Apply the algorithm / search in a sequence
+        template<typename Iter2>
+        Iter2 operator()(Iter2 first, Iter2 last) const;
+
+    private:
+        BoyerMoore<Iter> fallback_;
+        // Copy of the pattern when its elements are bytes
+        std::vector<unsigned char> bytes_;
+};
+
+
+template<typename Iter>
+SimdSearcher<Iter>::SimdSearcher(Iter first, Iter last) :
+    fallback_{first, last}
+{
+    if constexpr(implementation_detail::is_byte_like<value_type>)
+        for(; first != last; ++first)
+            bytes_.push_back(static_cast<unsigned char>(*first));
+}
+
+
+template<typename Iter>
+template<typename Iter2>
+Iter2 SimdSearcher<Iter>::operator()(Iter2 first, Iter2 last) const
+{
+#ifdef UTILITIES_BOYER_MOORE_SIMD
+    if constexpr(implementation_detail::is_byte_like<value_type> &&
+                 implementation_detail::is_byte_like<typename std::iterator_traits<Iter2>::value_type> &&
+                 implementation_detail::is_contiguous_iterator<Iter2>)
+    {
+        const size_t length = bytes_.size();
+        if(length == 0)
+            return first;
+        if(static_cast<size_t>(last - first) < length)
+            return last;
+
+        const auto* h = reinterpret_cast<const unsigned char*>(&*first);
+        return first + implementation_detail::simd_search(h, last - first, bytes_.data(), length);
+    }
+    else
+#endif
+        return fallback_(first, last);
 }
 
 #endif //UTILITIES_BOYER_MOORE_HPP
@@ -11,7 +11,7 @@
 
 struct ostream_state {};
 
-std::ostream& operator<<(std::ostream& out, const ostream_state& s)
+std::ostream& operator<<(std::ostream& out, const ostream_state&)
 {
     auto flags = out.flags();
     out << std::boolalpha;
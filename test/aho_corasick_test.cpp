@@ -0,0 +1,140 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+// Randomized comparison of AhoCorasick against a brute-force search of every pattern at every position. The pattern
+// sets are drawn from small alphabets, so that patterns overlap, nest in one another, repeat and are empty, and from
+// all 256 bytes with many patterns, so that the double array has to place crowded sets of children
+// Usage: aho_corasick_test [iterations [seed]]
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "aho_corasick.hpp"
+
+
+namespace
+{
+    size_t failures = 0;
+
+    void check(bool ok, const char* what, size_t patterns, size_t text)
+    {
+        if(!ok && failures++ < 20)
+            std::printf("FAILED %s, %zu patterns in a text of %zu bytes\n", what, patterns, text);
+    }
+
+    // Every occurrence, by end then longest first, the patterns with the same text in the order they were given
+    std::vector<std::tuple<size_t, size_t>> brute_force(const std::vector<std::string>& patterns, const std::string& text)
+    {
+        std::vector<std::tuple<size_t, size_t, size_t, size_t>> found;
+        for(size_t id = 0; id < patterns.size(); ++id)
+        {
+            const auto& p = patterns[id];
+            if(p.empty())
+                continue;
+            for(size_t at = 0; at + p.size() <= text.size(); ++at)
+                if(text.compare(at, p.size(), p) == 0)
+                    found.emplace_back(at + p.size(), ~p.size(), id, at);
+        }
+        std::sort(found.begin(), found.end());
+
+        std::vector<std::tuple<size_t, size_t>> matches;
+        for(const auto& [end, length, id, at] : found)
+            matches.emplace_back(id, at);
+        return matches;
+    }
+
+    std::string random_string(std::mt19937_64& rng, size_t size, unsigned letters, unsigned char base)
+    {
+        std::string s(size, '\0');
+        for(auto& c : s)
+            c = static_cast<char>(base + rng() % letters);
+        return s;
+    }
+
+    void compare(const std::vector<std::string>& patterns, const std::string& text)
+    {
+        const AhoCorasick automaton(patterns.begin(), patterns.end());
+        const auto expected = brute_force(patterns, text);
+
+        std::vector<std::tuple<size_t, size_t>> found;
+        for(const auto& m : automaton.find_all(text.begin(), text.end()))
+            found.emplace_back(m.pattern, m.offset);
+        check(found == expected, "find_all", patterns.size(), text.size());
+
+        // Single pass over an input iterator
+        std::istringstream in(text);
+        std::vector<std::tuple<size_t, size_t>> streamed;
+        automaton.for_each_match(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>(),
+                                 [&](size_t pattern, size_t offset) { streamed.emplace_back(pattern, offset); });
+        check(streamed == expected, "for_each_match on an input iterator", patterns.size(), text.size());
+
+        // One state per distinct prefix, the root being the empty one
+        std::set<std::string> prefixes{""};
+        for(const auto& p : patterns)
+            for(size_t k = 1; k <= p.size(); ++k)
+                prefixes.insert(p.substr(0, k));
+        check(automaton.pattern_count() == patterns.size() && automaton.state_count() == prefixes.size(), "counts",
+              patterns.size(), text.size());
+    }
+
+    void test(std::mt19937_64& rng, size_t iterations)
+    {
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            const unsigned letters = 1 + rng() % 4;
+            const unsigned char base = rng() % 2 ? 'a' : 0xfc;
+            const std::string text = random_string(rng, rng() % 300, letters, base);
+
+            // Patterns cut from the text or drawn at random, some of them empty or repeated
+            std::vector<std::string> patterns(rng() % 20);
+            for(auto& p : patterns)
+            {
+                const size_t size = rng() % 9;
+                if(rng() % 8 == 0 && !text.empty())
+                    p = text.substr(rng() % text.size(), size);
+                else if(rng() % 8 == 0 && &p != &patterns.front())
+                    p = (&p)[-1];
+                else
+                    p = random_string(rng, size, letters, base);
+            }
+            compare(patterns, text);
+        }
+
+        // Many patterns over all bytes
+        for(size_t i = 0; i < iterations / 500 + 2; ++i)
+        {
+            const std::string text = random_string(rng, 4000, 256, 0);
+            std::vector<std::string> patterns(1000 + rng() % 2000);
+            for(auto& p : patterns)
+                p = rng() % 4 == 0 ? text.substr(rng() % text.size(), 1 + rng() % 6)
+                                   : random_string(rng, 1 + rng() % 6, 256, 0);
+            compare(patterns, text);
+        }
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000;
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::random_device{}();
+    std::printf("aho_corasick_test %zu %llu\n", iterations, static_cast<unsigned long long>(seed));
+    std::mt19937_64 rng(seed);
+
+    test(rng, iterations);
+
+    // Only empty patterns, and no pattern at all
+    compare({"", ""}, "abc");
+    compare({}, "abc");
+
+    std::printf("%zu failures\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,936 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+// Randomized differential test of big_int.hpp and big_int_batch.hpp. Every operation is compared against
+// unsigned __int128 for the widths up to 128 bits and against the plain reference implementation below, written
+// for obviousness rather than speed, for all widths. Usage: big_int_fuzz [iterations [seed]]
+// The first failures are printed with their operands in hexadecimal and the exit status is 1 if there was any
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <initializer_list>
+#include "big_int.hpp"
+#include "big_int_batch.hpp"
+
+
+namespace reference
+{
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    // Magnitude, least significant limb first, without high zero limbs
+    using number = std::vector<uint64_t>;
+
+    number normalize(number a)
+    {
+        while(!a.empty() && a.back() == 0)
+            a.pop_back();
+        return a;
+    }
+
+    number word(uint64_t w)
+    {
+        return normalize({w});
+    }
+
+    int compare(const number& a, const number& b)
+    {
+        if(a.size() != b.size())
+            return a.size() < b.size() ? -1 : 1;
+        for(size_t i = a.size(); i-- > 0;)
+            if(a[i] != b[i])
+                return a[i] < b[i] ? -1 : 1;
+        return 0;
+    }
+
+    bool bit(const number& a, size_t i)
+    {
+        return i / 64 < a.size() && ((a[i / 64] >> (i % 64)) & 1);
+    }
+
+    size_t bit_width(const number& a)
+    {
+        size_t n = 64 * a.size();
+        while(n > 0 && !bit(a, n - 1))
+            --n;
+        return n;
+    }
+
+    number add(const number& a, const number& b)
+    {
+        number r(std::max(a.size(), b.size()) + 1);
+        uint128_t carry = 0;
+        for(size_t i = 0; i < r.size(); ++i)
+        {
+            carry += uint128_t(i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0);
+            r[i] = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+        return normalize(r);
+    }
+
+    // a - b, a must not be below b
+    number sub(const number& a, const number& b)
+    {
+        number r(a.size());
+        uint64_t borrow = 0;
+        for(size_t i = 0; i < a.size(); ++i)
+        {
+            const uint64_t y = i < b.size() ? b[i] : 0;
+            r[i] = a[i] - y - borrow;
+            borrow = (a[i] < y) || (a[i] - y < borrow);
+        }
+        return normalize(r);
+    }
+
+    number mul(const number& a, const number& b)
+    {
+        number r(a.size() + b.size());
+        for(size_t i = 0; i < a.size(); ++i)
+        {
+            uint128_t carry = 0;
+            for(size_t j = 0; j < b.size(); ++j)
+            {
+                carry += uint128_t(a[i]) * b[j] + r[i + j];
+                r[i + j] = static_cast<uint64_t>(carry);
+                carry >>= 64;
+            }
+            r[i + b.size()] = static_cast<uint64_t>(carry);
+        }
+        return normalize(r);
+    }
+
+    number shl(const number& a, size_t n)
+    {
+        number r(a.size() + n / 64 + 1);
+        for(size_t i = 0; i < a.size(); ++i)
+        {
+            r[i + n / 64] |= a[i] << (n % 64);
+            if(n % 64 != 0)
+                r[i + n / 64 + 1] |= a[i] >> (64 - n % 64);
+        }
+        return normalize(r);
+    }
+
+    number shr(const number& a, size_t n)
+    {
+        number r(a.size());
+        for(size_t i = n / 64; i < a.size(); ++i)
+        {
+            r[i - n / 64] |= a[i] >> (n % 64);
+            if(n % 64 != 0 && i > n / 64)
+                r[i - n / 64 - 1] |= a[i] << (64 - n % 64);
+        }
+        return normalize(r);
+    }
+
+    template<typename F>
+    number bitwise(const number& a, const number& b, F f)
+    {
+        number r(std::max(a.size(), b.size()));
+        for(size_t i = 0; i < r.size(); ++i)
+            r[i] = f(i < a.size() ? a[i] : 0, i < b.size() ? b[i] : 0);
+        return normalize(r);
+    }
+
+    // 2^bits - 1
+    number ones(size_t bits)
+    {
+        number r((bits + 63) / 64, ~uint64_t(0));
+        if(bits % 64 != 0)
+            r.back() >>= 64 - bits % 64;
+        return r;
+    }
+
+    number power_of_two(size_t n)
+    {
+        return shl({1}, n);
+    }
+
+    // a modulo 2^bits
+    number truncate(number a, size_t bits)
+    {
+        return bitwise(a, ones(bits), [](uint64_t x, uint64_t y) { return x & y; });
+    }
+
+    // -a modulo 2^bits
+    number negate(const number& a, size_t bits)
+    {
+        return truncate(sub(power_of_two(bits), truncate(a, bits)), bits);
+    }
+
+    // Long division one bit at a time, b must not be zero
+    std::pair<number, number> divmod(const number& a, const number& b)
+    {
+        number q(a.size()), r;
+        for(size_t i = bit_width(a); i-- > 0;)
+        {
+            r = shl(r, 1);
+            if(bit(a, i))
+                r = add(r, {1});
+            if(compare(r, b) >= 0)
+            {
+                r = sub(r, b);
+                q[i / 64] |= uint64_t(1) << (i % 64);
+            }
+        }
+        return {normalize(q), r};
+    }
+
+    // a / w in place, returns a % w
+    uint64_t divmod_word(number& a, uint64_t w)
+    {
+        uint128_t r = 0;
+        for(size_t i = a.size(); i-- > 0;)
+        {
+            r = (r << 64) | a[i];
+            a[i] = static_cast<uint64_t>(r / w);
+            r %= w;
+        }
+        a = normalize(a);
+        return static_cast<uint64_t>(r);
+    }
+
+    std::string to_string(number a, unsigned base)
+    {
+        std::string s;
+        do
+            s.push_back("0123456789abcdefghijklmnopqrstuvwxyz"[divmod_word(a, base)]);
+        while(!a.empty());
+        return std::string(s.rbegin(), s.rend());
+    }
+
+    number mulmod(const number& a, const number& b, const number& m)
+    {
+        return divmod(mul(a, b), m).second;
+    }
+
+    number powmod(const number& a, const number& e, const number& m)
+    {
+        number r = divmod({1}, m).second, x = divmod(a, m).second;
+        for(size_t i = bit_width(e); i-- > 0;)
+        {
+            r = mulmod(r, r, m);
+            if(bit(e, i))
+                r = mulmod(r, x, m);
+        }
+        return r;
+    }
+
+    number gcd(number a, number b)
+    {
+        while(!b.empty())
+        {
+            number r = divmod(a, b).second;
+            a = std::move(b);
+            b = std::move(r);
+        }
+        return a;
+    }
+}
+
+using reference::number;
+using reference::uint128_t;
+
+
+size_t failures = 0;
+
+std::string hex(const number& a)
+{
+    return reference::to_string(a, 16);
+}
+
+// Counts a failure, the first ones being printed with their operands
+bool check(bool ok, const char* what, size_t bits, std::initializer_list<number> operands = {})
+{
+    if(ok)
+        return true;
+
+    if(++failures <= 20)
+    {
+        std::printf("FAIL %s at %zu bits", what, bits);
+        for(const auto& x : operands)
+            std::printf(" 0x%s", hex(x).c_str());
+        std::printf("\n");
+    }
+    return false;
+}
+
+template<size_t N>
+number to_reference(const UInt<N>& a)
+{
+    const BigInt b(a);
+    return number(b.limbs(), b.limbs() + b.size());
+}
+
+template<size_t N>
+UInt<N> from_reference(const number& a)
+{
+    UInt<N> r;
+    for(size_t i = a.size(); i-- > 0;)
+    {
+        r <<= 64;
+        r |= a[i];
+    }
+    return r;
+}
+
+// Random value below 2^bits, biased toward the shapes that break carries and quotient estimates: zero, all ones,
+// single bits, long runs of ones or zeros and limbs at their extremes
+number random_number(std::mt19937_64& rng, size_t bits)
+{
+    number r((bits + 63) / 64);
+    switch(rng() % 8)
+    {
+        case 0:
+            r = reference::word(rng() % 3);
+            break;
+        case 1:
+            r = reference::ones(bits - rng() % std::min<size_t>(bits, 3));
+            break;
+        case 2:
+            r = reference::power_of_two(rng() % bits);
+            break;
+        case 3:
+        {
+            // Runs of ones and zeros of random lengths
+            bool one = rng() & 1;
+            for(size_t i = 0; i < bits;)
+            {
+                const size_t run = 1 + rng() % 150;
+                for(size_t k = i; k < std::min(bits, i + run); ++k)
+                    if(one)
+                        r[k / 64] |= uint64_t(1) << (k % 64);
+                i += run;
+                one = !one;
+            }
+            break;
+        }
+        case 4:
+        {
+            const uint64_t extremes[] = {0, 1, ~uint64_t(0), ~uint64_t(0) - 1, uint64_t(1) << 63, ~(uint64_t(1) << 63)};
+            for(auto& x : r)
+                x = rng() % 3 == 0 ? rng() : extremes[rng() % 6];
+            break;
+        }
+        case 5:
+            // Random width, for operands of different sizes
+            for(auto& x : r)
+                x = rng();
+            r = reference::truncate(r, 1 + rng() % bits);
+            break;
+        default:
+            for(auto& x : r)
+                x = rng();
+    }
+    return reference::truncate(reference::normalize(r), bits);
+}
+
+number nonzero_number(std::mt19937_64& rng, size_t bits)
+{
+    number r = random_number(rng, bits);
+    return r.empty() ? number{1} : r;
+}
+
+
+// UInt against the reference
+template<size_t N>
+void test_uint(std::mt19937_64& rng, size_t iterations)
+{
+    using namespace reference;
+    const auto wrap = [](const number& x) { return truncate(x, N); };
+    const auto is = [](const auto& a, const number& x) { return compare(to_reference(a), x) == 0; };
+
+    for(size_t it = 0; it < iterations; ++it)
+    {
+        const number x = random_number(rng, N), y = random_number(rng, N), z = random_number(rng, N);
+        const UInt<N> a = from_reference<N>(x), b = from_reference<N>(y), c = from_reference<N>(z);
+        if(!check(is(a, x), "round trip", N, {x}))
+            continue;
+
+        // Bit manipulation
+        check(is(~a, bitwise(x, ones(N), [](uint64_t p, uint64_t q) { return p ^ q; })), "~", N, {x});
+        check(is(a & b, bitwise(x, y, [](uint64_t p, uint64_t q) { return p & q; })), "&", N, {x, y});
+        check(is(a | b, bitwise(x, y, [](uint64_t p, uint64_t q) { return p | q; })), "|", N, {x, y});
+        check(is(a ^ b, bitwise(x, y, [](uint64_t p, uint64_t q) { return p ^ q; })), "^", N, {x, y});
+        const size_t n = rng() % (N + 70);
+        check(is(a << n, wrap(shl(x, n))), "<<", N, {x, word(n)});
+        check(is(a >> n, shr(x, n)), ">>", N, {x, word(n)});
+
+        // Comparisons
+        const int cmp = reference::compare(x, y);
+        check(compare(a, b) == cmp, "compare", N, {x, y});
+        check((a == b) == (cmp == 0) && (a != b) == (cmp != 0) && (a < b) == (cmp < 0) &&
+              (a <= b) == (cmp <= 0) && (a > b) == (cmp > 0) && (a >= b) == (cmp >= 0), "relational", N, {x, y});
+        check(compare(a, a) == 0 && a == a, "compare self", N, {x});
+
+        // Bit queries
+        const size_t width = reference::bit_width(x);
+        size_t trailing = 0, count = 0;
+        while(trailing < N && !reference::bit(x, trailing))
+            ++trailing;
+        for(size_t i = 0; i < N; ++i)
+            count += reference::bit(x, i);
+        check(bit_width(a) == width && countl_zero(a) == N - width, "bit_width", N, {x});
+        check(countr_zero(a) == trailing, "countr_zero", N, {x});
+        check(popcount(a) == count, "popcount", N, {x});
+
+        // Additive and multiplicative operators, the compound ones giving the same results
+        const number sum = wrap(add(x, y)), difference = wrap(add(x, negate(y, N))), product = wrap(mul(x, y));
+        check(is(a + b, sum), "+", N, {x, y});
+        check(is(a - b, difference), "-", N, {x, y});
+        check(is(a * b, product), "*", N, {x, y});
+        check(is(UInt<N>(a) += b, sum) && is(UInt<N>(a) -= b, difference) && is(UInt<N>(a) *= b, product),
+              "compound +-*", N, {x, y});
+        check(is(wide_mul(a, b), mul(x, y)), "wide_mul", N, {x, y});
+        check(is(sqr(a), wrap(mul(x, x))), "sqr", N, {x});
+        check(is(wide_sqr(a), mul(x, x)), "wide_sqr", N, {x});
+        UInt<N> acc = c;
+        check(is(mul_add(acc, a, b), wrap(add(z, mul(x, y)))), "mul_add", N, {z, x, y});
+
+        // Division, checked through q b + r = a with r < b which defines them
+        if(!y.empty())
+        {
+            const auto qr = divmod(a, b);
+            const number q = to_reference(qr.first), r = to_reference(qr.second);
+            check(reference::compare(add(mul(q, y), r), x) == 0 && reference::compare(r, y) < 0, "divmod", N, {x, y});
+            check(a / b == qr.first && a % b == qr.second, "/ %", N, {x, y});
+            check((UInt<N>(a) /= b) == qr.first && (UInt<N>(a) %= b) == qr.second, "compound / %", N, {x, y});
+        }
+        else
+            check(divmod(a, b).first == 0u && divmod(a, b).second == 0u, "divmod by zero", N, {x});
+
+        // Word operands
+        const uint64_t w = rng() % 4 == 0 ? ~uint64_t(0) - rng() % 3 : rng() >> (rng() % 64);
+        const number v = word(w), wide_sum = add(x, v);
+        check(is(a + w, N >= 64 ? wrap(wide_sum) : truncate(wide_sum, 64)), "+ word", N, {x, v});
+        check(is(UInt<N>(a) += w, wrap(wide_sum)) && is(UInt<N>(a) -= w, wrap(add(x, negate(v, N)))),
+              "compound +- word", N, {x, v});
+        check(is(UInt<N>(a) *= w, wrap(mul(x, v))), "*= word", N, {x, v});
+        UInt<N> acc_word = c;
+        check(is(mul_add_word(acc_word, a, w), wrap(add(z, mul(x, v)))), "mul_add_word", N, {z, x, v});
+        if(w != 0)
+        {
+            number q = x;
+            const uint64_t r = divmod_word(q, w);
+            const auto qr = divmod(a, w);
+            check(is(qr.first, q) && qr.second == r, "divmod word", N, {x, v});
+            check(is(a / w, q) && is(a % w, word(r)), "/ % word", N, {x, v});
+            check(is(UInt<N>(a) /= w, q) && is(UInt<N>(a) %= w, word(r)), "compound / % word", N, {x, v});
+        }
+
+        // Constant-time operations
+        check(equal(a, b, constant_time) == (cmp == 0) && compare(a, b, constant_time) == cmp, "ct compare",
+              N, {x, y});
+        check(select(true, a, b, constant_time) == a && select(false, a, b, constant_time) == b, "ct select",
+              N, {x, y});
+        UInt<N> s = a, t = b;
+        cswap(false, s, t, constant_time);
+        check(s == a && t == b, "ct cswap", N, {x, y});
+        cswap(true, s, t, constant_time);
+        check(s == b && t == a, "ct cswap", N, {x, y});
+
+        // String conversions
+        const int base = 2 + static_cast<int>(rng() % 35);
+        const std::string digits = to_string(x, static_cast<unsigned>(base));
+        char buffer[N + 2];
+        const auto written = to_chars(buffer, buffer + sizeof(buffer), a, base);
+        check(written.ec == std::errc() && std::string(buffer, written.ptr) == digits, "to_chars", N, {x, word(base)});
+        if(digits.size() > 1)
+            check(to_chars(buffer, buffer + digits.size() - 1, a, base).ec == std::errc::value_too_large,
+                  "to_chars too small", N, {x});
+
+        const std::string padded = std::string(rng() % 3, '0') + digits + "!";
+        UInt<N> parsed = c;
+        const auto read = from_chars(padded.data(), padded.data() + padded.size(), parsed, base);
+        check(read.ec == std::errc() && parsed == a && read.ptr == padded.data() + padded.size() - 1, "from_chars",
+              N, {x, word(base)});
+    }
+
+    // Limits of from_chars
+    using namespace reference;
+    for(int base : {2, 10, 16, 36})
+    {
+        const std::string largest = to_string(ones(N), base), overflow = to_string(power_of_two(N), base);
+        UInt<N> parsed;
+        check(from_chars(largest.data(), largest.data() + largest.size(), parsed, base).ec == std::errc() &&
+              parsed == from_reference<N>(ones(N)), "from_chars largest", N, {word(base)});
+        check(from_chars(overflow.data(), overflow.data() + overflow.size(), parsed, base).ec ==
+              std::errc::result_out_of_range, "from_chars overflow", N, {word(base)});
+        check(from_chars(overflow.data(), overflow.data(), parsed, base).ec == std::errc::invalid_argument,
+              "from_chars empty", N, {word(base)});
+    }
+}
+
+
+// UInt against unsigned __int128, for the widths it holds
+template<size_t N>
+void test_small(std::mt19937_64& rng, size_t iterations)
+{
+    static_assert(N <= 128, "");
+    constexpr uint128_t mask = N == 128 ? ~uint128_t(0) : (uint128_t(1) << N) - 1;
+    const auto value = [](const auto& a) {
+        const number r = to_reference(a);
+        return (r.size() > 0 ? uint128_t(r[0]) : 0) | (r.size() > 1 ? uint128_t(r[1]) << 64 : 0);
+    };
+
+    for(size_t it = 0; it < iterations; ++it)
+    {
+        const number rx = random_number(rng, N), ry = random_number(rng, N);
+        const UInt<N> a = from_reference<N>(rx), b = from_reference<N>(ry);
+        const uint128_t x = value(a), y = value(b);
+        const size_t n = rng() % N;
+
+        check(value(a + b) == ((x + y) & mask), "__int128 +", N, {rx, ry});
+        check(value(a - b) == ((x - y) & mask), "__int128 -", N, {rx, ry});
+        check(value(a * b) == ((x * y) & mask), "__int128 *", N, {rx, ry});
+        check(value(~a) == (~x & mask), "__int128 ~", N, {rx});
+        check(value(a & b) == (x & y) && value(a | b) == (x | y) && value(a ^ b) == (x ^ y), "__int128 & | ^",
+              N, {rx, ry});
+        check(value(a << n) == ((x << n) & mask) && value(a >> n) == (x >> n), "__int128 << >>", N, {rx, ry});
+        check((a < b) == (x < y) && (a == b) == (x == y) && (a > b) == (x > y), "__int128 compare", N, {rx, ry});
+        if(y != 0)
+            check(value(a / b) == x / y && value(a % b) == x % y, "__int128 / %", N, {rx, ry});
+    }
+}
+
+
+// Operators mixing two widths, the result taking the wider one (the one of the dividend for /, the narrower one
+// for %)
+template<size_t N, size_t M>
+void test_mixed(std::mt19937_64& rng, size_t iterations)
+{
+    using namespace reference;
+    constexpr size_t wide = std::max(N, M);
+    const auto is = [](const auto& a, const number& x) { return compare(to_reference(a), x) == 0; };
+
+    for(size_t it = 0; it < iterations; ++it)
+    {
+        const number x = random_number(rng, N), y = random_number(rng, M);
+        const UInt<N> a = from_reference<N>(x);
+        const UInt<M> b = from_reference<M>(y);
+
+        check(is(a + b, truncate(add(x, y), wide)), "mixed +", N, {x, y});
+        check(is(a - b, truncate(add(x, negate(y, wide)), wide)), "mixed -", N, {x, y});
+        check(is(a * b, truncate(mul(x, y), wide)), "mixed *", N, {x, y});
+        check(is(UInt<N>(a) += b, truncate(add(x, y), N)), "mixed +=", N, {x, y});
+        check(is(UInt<N>(a) *= b, truncate(mul(x, y), N)), "mixed *=", N, {x, y});
+        check(compare(a, b) == reference::compare(x, y), "mixed compare", N, {x, y});
+        check(is(UInt<M>(a), truncate(x, M)), "mixed conversion", N, {x});
+        if(!y.empty())
+        {
+            const auto qr = reference::divmod(x, y);
+            check(is(a / b, qr.first) && is(a % b, qr.second), "mixed / %", N, {x, y});
+        }
+    }
+}
+
+
+// Int against the reference, the signed values being held modulo 2^N
+template<size_t N>
+void test_int(std::mt19937_64& rng, size_t iterations)
+{
+    using namespace reference;
+    const auto is = [](const Int<N>& a, const number& x) { return compare(to_reference(a.bits()), x) == 0; };
+    const auto negative = [](const number& x) { return bit(x, N - 1); };
+    const auto magnitude = [&](const number& x) { return negative(x) ? negate(x, N) : x; };
+    const auto with_sign = [](const number& m, bool minus, size_t bits) {
+        return minus ? negate(m, bits) : truncate(m, bits);
+    };
+
+    for(size_t it = 0; it < iterations; ++it)
+    {
+        const number x = random_number(rng, N), y = random_number(rng, N);
+        const Int<N> a(from_reference<N>(x)), b(from_reference<N>(y));
+        const number mx = magnitude(x), my = magnitude(y);
+
+        check(a.is_negative() == negative(x) && a.sign() == (negative(x) ? -1 : !x.empty()), "Int sign", N, {x});
+        check(compare(to_reference(a.magnitude()), mx) == 0, "Int magnitude", N, {x});
+        check(is(-a, negate(x, N)), "Int -", N, {x});
+
+        // Signed order: the negative values first, then by magnitude
+        const int cmp = negative(x) != negative(y) ? (negative(x) ? -1 : 1) : reference::compare(x, y);
+        check(compare(a, b) == cmp && (a < b) == (cmp < 0) && (a >= b) == (cmp >= 0), "Int compare", N, {x, y});
+
+        // Truncated division
+        if(!y.empty())
+        {
+            const auto qr = reference::divmod(mx, my);
+            const auto result = divmod(a, b);
+            check(is(result.first, with_sign(qr.first, negative(x) != negative(y), N)) &&
+                  is(result.second, with_sign(qr.second, negative(x), N)), "Int divmod", N, {x, y});
+            check(a / b == result.first && a % b == result.second, "Int / %", N, {x, y});
+        }
+
+        // Arithmetic shift, floor(a / 2^n)
+        const size_t n = rng() % (N + 10);
+        const number flipped = bitwise(x, ones(N), [](uint64_t p, uint64_t q) { return p ^ q; });
+        const number shifted = negative(x) ? bitwise(shr(flipped, n), ones(N), [](uint64_t p, uint64_t q) { return p ^ q; })
+                                           : shr(x, n);
+        check(is(a >> n, shifted), "Int >>", N, {x, word(n)});
+
+        // Sign extension and truncation
+        const Int<N + 70> widened(a);
+        check(compare(to_reference(widened.bits()), with_sign(mx, negative(x), N + 70)) == 0, "Int widen", N, {x});
+        const Int<N / 2 + 1> narrowed(a);
+        check(compare(to_reference(narrowed.bits()), truncate(x, N / 2 + 1)) == 0, "Int narrow", N, {x});
+        const int64_t small = static_cast<int64_t>(rng());
+        check(is(Int<N>(small), with_sign(word(small < 0 ? 0 - static_cast<uint64_t>(small) : small), small < 0, N)),
+              "Int from int64_t", N, {word(static_cast<uint64_t>(small))});
+
+        // Full product
+        const Int<2 * N> product = wide_mul(a, b);
+        check(compare(to_reference(product.bits()), with_sign(mul(mx, my), negative(x) != negative(y), 2 * N)) == 0,
+              "Int wide_mul", N, {x, y});
+
+        // Strings, with a '-' before the magnitude
+        const std::string digits = (negative(x) ? "-" : "") + to_string(mx, 10);
+        char buffer[N + 3];
+        const auto written = to_chars(buffer, buffer + sizeof(buffer), a);
+        check(written.ec == std::errc() && std::string(buffer, written.ptr) == digits, "Int to_chars", N, {x});
+        Int<N> parsed;
+        check(from_chars(digits.data(), digits.data() + digits.size(), parsed).ec == std::errc() && parsed == a,
+              "Int from_chars", N, {x});
+    }
+
+    // The magnitude 2^(N-1) only fits with a '-'
+    const std::string smallest = "-" + to_string(power_of_two(N - 1), 10);
+    Int<N> parsed;
+    check(from_chars(smallest.data(), smallest.data() + smallest.size(), parsed).ec == std::errc() &&
+          is(parsed, power_of_two(N - 1)), "Int from_chars smallest", N);
+    check(from_chars(smallest.data() + 1, smallest.data() + smallest.size(), parsed).ec ==
+          std::errc::result_out_of_range, "Int from_chars overflow", N);
+}
+
+
+// fixed_decimal products and quotients against the exact rational result rounded by hand, and decimal_accumulator
+// against the exact sum
+template<size_t N, unsigned Scale>
+void test_decimal(std::mt19937_64& rng, size_t iterations)
+{
+    using namespace reference;
+    using decimal = fixed_decimal<N, Scale>;
+    const number unit = to_reference(decimal::unit);
+    const auto raw_of = [](const number& m, bool minus) {
+        return decimal::from_raw(Int<N>(from_reference<N>(minus ? negate(m, N) : m)));
+    };
+    const auto is = [](const decimal& a, const number& m, bool minus) {
+        return compare(to_reference(a.raw().bits()), minus ? negate(m, N) : truncate(m, N)) == 0;
+    };
+    // q rounded after a division that left r out of d
+    const auto round = [](number q, const number& r, const number& d, decimal_rounding mode) {
+        if(r.empty() || mode == decimal_rounding::toward_zero)
+            return q;
+        const int half = compare(add(r, r), d);
+        if(half > 0 || (half == 0 && (mode == decimal_rounding::half_away_from_zero || bit(q, 0))))
+            q = add(q, {1});
+        return q;
+    };
+    const size_t unit_bits = bit_width(unit);
+
+    decimal_accumulator<N, Scale> total, left, right;
+    number positive, negative;
+    for(size_t it = 0; it < iterations; ++it)
+    {
+        // Small enough for the exact product and quotient to fit in N - 1 bits. One time in four the product is
+        // by 0.5 and the quotient by 2, which makes ties for the odd raw values
+        const bool tie = it % 4 == 0;
+        const number x = random_number(rng, (N - 2) / 2);
+        const number y = tie ? divmod(unit, {2}).first : random_number(rng, (N - 2) / 2);
+        const number u = random_number(rng, N - 2 - unit_bits);
+        const number v = tie ? add(unit, unit) : nonzero_number(rng, N - 2);
+        const bool sx = rng() & 1, sy = rng() & 1;
+        const decimal a = raw_of(x, sx), b = raw_of(y, sy), c = raw_of(u, sx), d = raw_of(v, sy);
+
+        for(const auto mode : {decimal_rounding::toward_zero, decimal_rounding::half_away_from_zero,
+                               decimal_rounding::half_even})
+        {
+            const auto p = reference::divmod(mul(x, y), unit);
+            const number product = round(p.first, p.second, unit, mode);
+            check(is(mul(a, b, mode), product, sx != sy && !product.empty()), "fixed_decimal mul", N, {x, y});
+
+            const auto q = reference::divmod(mul(u, unit), v);
+            const number quotient = round(q.first, q.second, v, mode);
+            check(is(div(c, d, mode), quotient, sx != sy && !quotient.empty()), "fixed_decimal div", N, {u, v});
+        }
+        check(a * b == mul(a, b, decimal_rounding::half_even) && c / d == div(c, d, decimal_rounding::half_even),
+              "fixed_decimal * /", N, {x, y});
+
+        // Strings: the digits of the raw value with a '.' before the Scale last ones
+        std::string digits = to_string(x, 10);
+        if(digits.size() <= Scale)
+            digits.insert(0, Scale + 1 - digits.size(), '0');
+        if(Scale != 0)
+            digits.insert(digits.size() - Scale, ".");
+        if(sx && !x.empty())
+            digits.insert(0, "-");
+        char buffer[N + Scale + 4];
+        const auto written = to_chars(buffer, buffer + sizeof(buffer), a);
+        check(written.ec == std::errc() && std::string(buffer, written.ptr) == digits, "fixed_decimal to_chars",
+              N, {x});
+        decimal parsed;
+        check(from_chars(digits.data(), digits.data() + digits.size(), parsed).ec == std::errc() && parsed == a,
+              "fixed_decimal from_chars", N, {x});
+
+        // Sums split between two accumulators then merged
+        const number term = random_number(rng, N - 1);
+        const bool minus = rng() & 1;
+        (it % 2 ? left : right) += raw_of(term, minus);
+        total += raw_of(term, minus);
+        (minus ? negative : positive) = add(minus ? negative : positive, term);
+    }
+
+    const bool minus = compare(negative, positive) > 0;
+    const number m = minus ? sub(negative, positive) : sub(positive, negative);
+    const number expected = minus ? negate(m, N + 64) : m;
+    left += right;
+    check(compare(to_reference(total.sum().raw().bits()), expected) == 0 &&
+          compare(to_reference(left.sum().raw().bits()), expected) == 0, "decimal_accumulator", N, {m});
+}
+
+
+// Modular arithmetic against products reduced by long division, with small exponents to keep the reference fast
+template<size_t N>
+void test_modular(std::mt19937_64& rng, size_t iterations)
+{
+    using namespace reference;
+    const auto is = [](const UInt<N>& a, const number& x) { return compare(to_reference(a), x) == 0; };
+
+    for(size_t it = 0; it < iterations; ++it)
+    {
+        number mod = nonzero_number(rng, N);
+        if(compare(mod, {3}) < 0)
+            mod = {3};
+        const number odd = bitwise(mod, {1}, [](uint64_t p, uint64_t q) { return p | q; });
+        const number x = divmod(random_number(rng, N), odd).second, y = divmod(random_number(rng, N), odd).second;
+        const number e = random_number(rng, 1 + rng() % 48);
+        const UInt<N> m = from_reference<N>(odd), a = from_reference<N>(x), b = from_reference<N>(y);
+        const UInt<64> exponent = from_reference<64>(e);
+
+        const number product = mulmod(x, y, odd), power = powmod(x, e, odd);
+        check(is(modmul(a, b, m), product), "modmul", N, {x, y, odd});
+
+        const Montgomery<N> montgomery(m);
+        const UInt<N> ma = montgomery.to_montgomery(a), mb = montgomery.to_montgomery(b);
+        check(is(montgomery.from_montgomery(ma), x), "Montgomery round trip", N, {x, odd});
+        check(is(montgomery.from_montgomery(montgomery.mul(ma, mb)), product) &&
+              is(montgomery.from_montgomery(montgomery.mul(ma, mb, constant_time)), product) &&
+              is(montgomery.modmul(a, b), product), "Montgomery mul", N, {x, y, odd});
+        check(is(montgomery.from_montgomery(montgomery.sqr(ma)), mulmod(x, x, odd)) &&
+              is(montgomery.from_montgomery(montgomery.sqr(ma, constant_time)), mulmod(x, x, odd)),
+              "Montgomery sqr", N, {x, odd});
+        check(is(montgomery.modpow(a, exponent), power) && is(montgomery.modpow(a, exponent, constant_time), power) &&
+              is(modpow(a, exponent, m), power) && is(modpow(a, exponent, m, constant_time), power),
+              "Montgomery modpow", N, {x, e, odd});
+
+        // Barrett takes any modulus, the even ones included
+        const number xm = divmod(x, mod).second, ym = divmod(y, mod).second;
+        const UInt<N> mm = from_reference<N>(mod), am = from_reference<N>(xm), bm = from_reference<N>(ym);
+        const Barrett<N> barrett(mm);
+        const number product_m = mulmod(xm, ym, mod), power_m = powmod(xm, e, mod);
+        check(is(barrett.mul(am, bm), product_m) && is(barrett.sqr(am), mulmod(xm, xm, mod)), "Barrett mul", N,
+              {xm, ym, mod});
+        check(is(barrett.reduce(wide_mul(am, bm)), product_m), "Barrett reduce", N, {xm, ym, mod});
+        check(is(barrett.modpow(am, exponent), power_m) && is(modpow(am, exponent, mm), power_m), "Barrett modpow",
+              N, {xm, e, mod});
+
+        // The inverse exists for the values coprime with the modulus
+        const UInt<N> inverse = modinv(am, mm);
+        if(compare(gcd(xm, mod), {1}) == 0)
+            check(compare(to_reference(inverse), mod) < 0 &&
+                  compare(mulmod(to_reference(inverse), xm, mod), divmod({1}, mod).second) == 0, "modinv", N,
+                  {xm, mod});
+        else
+            check(inverse == 0u, "modinv not coprime", N, {xm, mod});
+    }
+}
+
+
+// BigInt against the reference, values being a sign and a magnitude of min_bits to max_bits
+void test_bigint(std::mt19937_64& rng, size_t iterations, size_t min_bits, size_t max_bits)
+{
+    using namespace reference;
+    struct value
+    {
+        bool negative;
+        number magnitude;
+    };
+    const auto make = [](const value& v) {
+        BigInt r(from_reference<64>(v.magnitude.empty() ? number{} : number{v.magnitude[0]}));
+        for(size_t i = v.magnitude.size(); i-- > 1;)
+            r += BigInt(from_reference<64>({v.magnitude[i]})) << (64 * i);
+        return v.negative ? -r : r;
+    };
+    const auto is = [](const BigInt& a, const value& v) {
+        return a.is_negative() == (v.negative && !v.magnitude.empty()) &&
+               compare(number(a.limbs(), a.limbs() + a.size()), v.magnitude) == 0;
+    };
+    const auto add_signed = [](const value& a, const value& b) {
+        if(a.negative == b.negative)
+            return value{a.negative, add(a.magnitude, b.magnitude)};
+        if(compare(a.magnitude, b.magnitude) >= 0)
+            return value{a.negative, sub(a.magnitude, b.magnitude)};
+        return value{b.negative, sub(b.magnitude, a.magnitude)};
+    };
+
+    for(size_t it = 0; it < iterations; ++it)
+    {
+        const size_t bits = min_bits + rng() % (max_bits - min_bits + 1);
+        const value x{static_cast<bool>(rng() & 1), random_number(rng, bits)};
+        const value y{static_cast<bool>(rng() & 1), random_number(rng, min_bits + rng() % (max_bits - min_bits + 1))};
+        const BigInt a = make(x), b = make(y);
+        if(!check(is(a, x), "BigInt round trip", bits, {x.magnitude}))
+            continue;
+
+        check(is(a + b, add_signed(x, y)), "BigInt +", bits, {x.magnitude, y.magnitude});
+        check(is(a - b, add_signed(x, {!y.negative, y.magnitude})), "BigInt -", bits, {x.magnitude, y.magnitude});
+        check(is(a * b, {x.negative != y.negative, mul(x.magnitude, y.magnitude)}), "BigInt *", bits,
+              {x.magnitude, y.magnitude});
+
+        const bool sx = x.negative && !x.magnitude.empty(), sy = y.negative && !y.magnitude.empty();
+        const int cmp = sx != sy ? (sx ? -1 : 1) : (sx ? -1 : 1) * compare(x.magnitude, y.magnitude);
+        check(compare(a, b) == cmp, "BigInt compare", bits, {x.magnitude, y.magnitude});
+
+        // Quotient toward zero, remainder of the sign of a
+        if(!y.magnitude.empty())
+        {
+            const auto qr = divmod(a, b);
+            const number q(qr.first.limbs(), qr.first.limbs() + qr.first.size());
+            const number r(qr.second.limbs(), qr.second.limbs() + qr.second.size());
+            check(compare(add(mul(q, y.magnitude), r), x.magnitude) == 0 && compare(r, y.magnitude) < 0 &&
+                  qr.first.is_negative() == (x.negative != y.negative && !q.empty()) &&
+                  qr.second.is_negative() == (x.negative && !r.empty()), "BigInt divmod", bits,
+                  {x.magnitude, y.magnitude});
+            check(a / b == qr.first && a % b == qr.second, "BigInt / %", bits, {x.magnitude, y.magnitude});
+        }
+
+        // Shifts of the two's complement value, >> rounding toward minus infinity
+        const size_t n = rng() % 200;
+        check(is(a << n, {x.negative, shl(x.magnitude, n)}), "BigInt <<", bits, {x.magnitude, word(n)});
+        number floor = shr(x.magnitude, n);
+        if(x.negative && compare(shl(floor, n), x.magnitude) != 0)
+            floor = add(floor, {1});
+        check(is(a >> n, {x.negative, floor}), "BigInt >>", bits, {x.magnitude, word(n)});
+
+        // Strings
+        const int base = rng() & 1 ? 10 : 2 + static_cast<int>(rng() % 35);
+        const std::string digits = (x.negative && !x.magnitude.empty() ? "-" : "") +
+                                   to_string(x.magnitude, static_cast<unsigned>(base));
+        std::string buffer(digits.size() + 1, ' ');
+        const auto written = to_chars(buffer.data(), buffer.data() + buffer.size(), a, base);
+        check(written.ec == std::errc() && std::string(buffer.data(), written.ptr) == digits, "BigInt to_chars",
+              bits, {x.magnitude, word(base)});
+        BigInt parsed;
+        check(from_chars(digits.data(), digits.data() + digits.size(), parsed, base).ec == std::errc() &&
+              parsed == a, "BigInt from_chars", bits, {x.magnitude, word(base)});
+    }
+}
+
+
+// UIntBatch against the reference value by value, on a count that is not a multiple of the lanes
+template<size_t N>
+void test_batch(std::mt19937_64& rng, size_t iterations)
+{
+    using namespace reference;
+    for(size_t it = 0; it < iterations; ++it)
+    {
+        const size_t count = 1 + rng() % 21;
+        std::vector<number> x(count), y(count);
+        std::vector<UInt<N>> a(count), b(count);
+        for(size_t i = 0; i < count; ++i)
+        {
+            x[i] = random_number(rng, N);
+            y[i] = random_number(rng, N);
+            a[i] = from_reference<N>(x[i]);
+            b[i] = from_reference<N>(y[i]);
+        }
+
+        const UIntBatch<N> p(a.data(), count), q(b.data(), count);
+        UIntBatch<N> sum = p, difference = p, product = p;
+        sum += q;
+        difference -= q;
+        product *= q;
+        for(size_t i = 0; i < count; ++i)
+        {
+            check(p.get(i) == a[i], "UIntBatch get", N, {x[i]});
+            check(compare(to_reference(sum.get(i)), truncate(add(x[i], y[i]), N)) == 0, "UIntBatch +=", N,
+                  {x[i], y[i]});
+            check(compare(to_reference(difference.get(i)), truncate(add(x[i], negate(y[i], N)), N)) == 0,
+                  "UIntBatch -=", N, {x[i], y[i]});
+            check(compare(to_reference(product.get(i)), truncate(mul(x[i], y[i]), N)) == 0, "UIntBatch *=", N,
+                  {x[i], y[i]});
+        }
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100;
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::random_device()();
+    std::printf("big_int_fuzz %zu %llu\n", iterations, static_cast<unsigned long long>(seed));
+    std::mt19937_64 rng(seed);
+
+    // Around the limb boundaries and the thresholds of the multiplication (Karatsuba from 24 limbs, Toom-3 from
+    // 192), the division (divide and conquer from 48) and the conversions
+    test_small<1>(rng, 4 * iterations);
+    test_small<7>(rng, 4 * iterations);
+    test_small<63>(rng, 4 * iterations);
+    test_small<64>(rng, 4 * iterations);
+    test_small<65>(rng, 4 * iterations);
+    test_small<127>(rng, 4 * iterations);
+    test_small<128>(rng, 4 * iterations);
+
+    test_uint<1>(rng, iterations);
+    test_uint<7>(rng, iterations);
+    test_uint<64>(rng, iterations);
+    test_uint<65>(rng, iterations);
+    test_uint<128>(rng, iterations);
+    test_uint<192>(rng, iterations);
+    test_uint<511>(rng, iterations);
+    test_uint<1000>(rng, iterations);
+    test_uint<1536>(rng, iterations);
+    test_uint<2048>(rng, iterations / 2);
+    test_uint<3100>(rng, iterations / 4);
+    test_uint<4096>(rng, iterations / 4);
+    test_uint<8192>(rng, iterations / 8);
+    test_uint<13000>(rng, iterations / 16);
+
+    test_mixed<128, 64>(rng, iterations);
+    test_mixed<100, 300>(rng, iterations);
+    test_mixed<1024, 192>(rng, iterations);
+    test_mixed<64, 4096>(rng, iterations);
+
+    test_int<2>(rng, iterations);
+    test_int<64>(rng, iterations);
+    test_int<100>(rng, iterations);
+    test_int<256>(rng, iterations);
+    test_int<1000>(rng, iterations / 4);
+
+    test_decimal<64, 2>(rng, iterations);
+    test_decimal<128, 4>(rng, iterations);
+    test_decimal<128, 18>(rng, iterations);
+    test_decimal<256, 30>(rng, iterations);
+    test_decimal<512, 60>(rng, iterations / 2);
+
+    test_modular<64>(rng, iterations / 2);
+    test_modular<128>(rng, iterations / 2);
+    test_modular<256>(rng, iterations / 4);
+    test_modular<1024>(rng, iterations / 20 + 1);
+    test_modular<2048>(rng, iterations / 50 + 1);
+
+    // Then at sizes where the product goes through the number-theoretic transform (from 1626 limbs below 2048)
+    test_bigint(rng, iterations, 1, 3000);
+    test_bigint(rng, iterations / 25 + 4, 1700 * 64, 2040 * 64);
+
+    test_batch<64>(rng, iterations / 4);
+    test_batch<200>(rng, iterations / 4);
+    test_batch<1024>(rng, iterations / 8);
+
+    std::printf("%zu failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
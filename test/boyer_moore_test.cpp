@@ -0,0 +1,121 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+// Randomized comparison of BoyerMoore against std::search. Small alphabets make the partial matches, periodic
+// patterns and overlapping matches that the shift tables get wrong, long texts split find_all into chunks
+// searched on several threads. Usage: boyer_moore_test [iterations [seed]]
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "boyer_moore.hpp"
+
+
+namespace
+{
+    size_t failures = 0;
+
+    template<typename T>
+    void check(bool ok, const char* what, const std::vector<T>& pattern, const std::vector<T>& text)
+    {
+        if(!ok && failures++ < 20)
+            std::printf("FAILED %s, pattern of %zu elements in a text of %zu\n", what, pattern.size(), text.size());
+    }
+
+    // Every match, overlapping ones included
+    template<typename T>
+    std::vector<size_t> all_matches(const std::vector<T>& pattern, const std::vector<T>& text)
+    {
+        std::vector<size_t> matches;
+        if(pattern.empty())
+            return matches;
+        for(auto it = text.begin(); (it = std::search(it, text.end(), pattern.begin(), pattern.end())) != text.end();
+            ++it)
+            matches.push_back(it - text.begin());
+        return matches;
+    }
+
+    template<typename T, typename Make>
+    std::vector<T> random_sequence(std::mt19937_64& rng, size_t size, unsigned letters, Make make)
+    {
+        std::vector<T> s(size);
+        for(auto& x : s)
+            x = make(rng() % letters);
+        return s;
+    }
+
+    // A pattern drawn from the text half of the time, so that there are matches even on larger alphabets
+    template<typename T, typename Make>
+    std::vector<T> random_pattern(std::mt19937_64& rng, const std::vector<T>& text, size_t size, unsigned letters,
+                                  Make make)
+    {
+        if(rng() % 2 == 0 || text.size() < size)
+            return random_sequence<T>(rng, size, letters, make);
+        const size_t at = rng() % (text.size() - size + 1);
+        return std::vector<T>(text.begin() + at, text.begin() + at + size);
+    }
+
+    template<typename T>
+    void compare(const std::vector<T>& pattern, const std::vector<T>& text, size_t threads)
+    {
+        using iterator = typename std::vector<T>::const_iterator;
+        const BoyerMoore<iterator> searcher(pattern.cbegin(), pattern.cend());
+        const auto expected = all_matches(pattern, text);
+
+        const auto found = searcher(text.cbegin(), text.cend());
+        check(found == std::search(text.cbegin(), text.cend(), pattern.cbegin(), pattern.cend()), "operator()",
+              pattern, text);
+
+        std::vector<size_t> each;
+        searcher.for_each_match(text.cbegin(), text.cend(), [&](iterator it) { each.push_back(it - text.cbegin()); });
+        check(each == expected, "for_each_match", pattern, text);
+
+        std::vector<size_t> all;
+        for(const auto it : searcher.find_all(text.cbegin(), text.cend(), threads))
+            all.push_back(it - text.cbegin());
+        check(all == expected, "find_all", pattern, text);
+    }
+
+    template<typename T, typename Make>
+    void test(std::mt19937_64& rng, size_t iterations, Make make)
+    {
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            const unsigned letters = 1 + rng() % 4;
+            const auto text = random_sequence<T>(rng, rng() % 200, letters, make);
+            compare(random_pattern<T>(rng, text, rng() % 13, letters, make), text, 1 + rng() % 4);
+        }
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::random_device{}();
+    std::printf("boyer_moore_test %zu %llu\n", iterations, static_cast<unsigned long long>(seed));
+    std::mt19937_64 rng(seed);
+
+    // The three bad element tables: flat for bytes, hashed, ordered
+    test<char>(rng, iterations, [](unsigned x) { return static_cast<char>('a' + x); });
+    test<int>(rng, iterations / 4, [](unsigned x) { return static_cast<int>(x) - 2; });
+    test<std::pair<int, int>>(rng, iterations / 4, [](unsigned x) { return std::make_pair(int(x % 2), int(x / 2)); });
+
+    // Texts long enough for find_all to use several chunks, matches straddling their boundaries
+    for(size_t i = 0; i < 6; ++i)
+    {
+        const unsigned letters = 1 + i % 3;
+        const auto make = [](unsigned x) { return static_cast<char>('a' + x); };
+        const auto text = random_sequence<char>(rng, 5 * BoyerMoore<const char*>::min_chunk_size + rng() % 1000,
+                                                letters, make);
+        compare(random_pattern<char>(rng, text, 1 + rng() % 12, letters, make), text, 2 + i);
+    }
+
+    std::printf("%zu failures\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,105 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+// Randomized comparison of SimdSearcher against std::search. The texts are exactly as long as their buffers, so that
+// a vector load past the end shows under AddressSanitizer, and their lengths cross many multiples of the vector
+// width. The vector width is the one the compiler targets: this file is built once per width
+// Usage: simd_searcher_test [iterations [seed]], the exit status is 77 when the processor lacks the instructions
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+#include "boyer_moore.hpp"
+
+
+namespace
+{
+    size_t failures = 0;
+
+    void check(bool ok, const char* what, size_t pattern, size_t text)
+    {
+        if(!ok && failures++ < 20)
+            std::printf("FAILED %s, pattern of %zu elements in a text of %zu\n", what, pattern, text);
+    }
+
+    // Searches a copy of text held in container C, with a pattern held in a std::vector<T>
+    template<typename C, typename T>
+    void compare(const char* what, const std::vector<T>& pattern, const std::vector<T>& text)
+    {
+        const C haystack(text.begin(), text.end());
+        const SimdSearcher<typename std::vector<T>::const_iterator> searcher(pattern.cbegin(), pattern.cend());
+        const auto found = searcher(haystack.begin(), haystack.end());
+        const auto expected = std::search(haystack.begin(), haystack.end(), pattern.begin(), pattern.end());
+        check(found == expected, what, pattern.size(), text.size());
+
+        // From every match on, as a caller looking for the next one would
+        if(!pattern.empty())
+            for(auto it = found; it != haystack.end(); ++it)
+                if(searcher(it, haystack.end()) != std::search(it, haystack.end(), pattern.begin(), pattern.end()))
+                {
+                    check(false, what, pattern.size(), text.size());
+                    break;
+                }
+    }
+
+    template<typename T>
+    void test(std::mt19937_64& rng, size_t iterations)
+    {
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            // Up to three letters, sometimes with the high bit set to catch a signed compare
+            const unsigned letters = 1 + rng() % 3;
+            const unsigned char base = rng() % 2 ? 'a' : 0xf0;
+            const auto letter = [&] { return static_cast<T>(base + rng() % letters); };
+
+            std::vector<T> text(rng() % 300);
+            std::generate(text.begin(), text.end(), letter);
+            std::vector<T> pattern(rng() % 8 == 0 ? rng() % 70 : rng() % 10);
+            if(rng() % 2 == 0 && pattern.size() <= text.size())
+            {
+                const size_t at = rng() % (text.size() - pattern.size() + 1);
+                std::copy_n(text.begin() + at, pattern.size(), pattern.begin());
+            }
+            else
+                std::generate(pattern.begin(), pattern.end(), letter);
+
+            compare<std::vector<T>>("vector", pattern, text);
+            compare<std::deque<T>>("deque (fallback)", pattern, text);
+            if constexpr(std::is_same_v<T, char>)
+                compare<std::string>("string", pattern, text);
+        }
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+#if defined(__AVX2__)
+    const char* width = "AVX2";
+    if(!__builtin_cpu_supports("avx2"))
+        return 77;
+#elif defined(UTILITIES_BOYER_MOORE_SIMD)
+    const char* width = "SSE2";
+#else
+    const char* width = "none";
+#endif
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::random_device{}();
+    std::printf("simd_searcher_test %zu %llu, vectors: %s\n", iterations, static_cast<unsigned long long>(seed),
+                width);
+    std::mt19937_64 rng(seed);
+
+    test<char>(rng, iterations);
+    test<unsigned char>(rng, iterations / 4);
+    test<signed char>(rng, iterations / 4);
+    test<std::byte>(rng, iterations / 4);
+
+    std::printf("%zu failures\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,98 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+// Randomized comparison of StreamSearcher against std::search on the whole stream. The stream is cut at random
+// points, empty and one-element chunks included, and every chunk is copied into a buffer freed right after it is
+// searched, so that a match across chunks can only come from the tail the searcher keeps
+// Usage: stream_searcher_test [iterations [seed]]
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "boyer_moore.hpp"
+
+
+namespace
+{
+    size_t failures = 0;
+
+    void check(bool ok, const char* what, size_t pattern, size_t text)
+    {
+        if(!ok && failures++ < 20)
+            std::printf("FAILED %s, pattern of %zu elements in a stream of %zu\n", what, pattern, text);
+    }
+
+    template<typename T>
+    std::vector<size_t> all_matches(const std::vector<T>& pattern, const std::vector<T>& text)
+    {
+        std::vector<size_t> matches;
+        if(pattern.empty())
+            return matches;
+        for(auto it = text.begin(); (it = std::search(it, text.end(), pattern.begin(), pattern.end())) != text.end();
+            ++it)
+            matches.push_back(it - text.begin());
+        return matches;
+    }
+
+    // Offsets reported for text fed in chunks of random sizes, mostly shorter than the pattern
+    template<typename T, typename Searcher>
+    std::vector<size_t> feed(std::mt19937_64& rng, Searcher& searcher, const std::vector<T>& text, size_t pattern)
+    {
+        std::vector<size_t> found;
+        for(size_t at = 0; at < text.size();)
+        {
+            const size_t limit = rng() % 3 == 0 ? 4 * pattern + 8 : pattern + 2;
+            const size_t size = std::min(text.size() - at, rng() % limit);
+            const std::vector<T> chunk(text.begin() + at, text.begin() + at + size);
+            searcher(chunk.begin(), chunk.end(), [&](size_t offset) { found.push_back(offset); });
+            at += size;
+        }
+        return found;
+    }
+
+    template<typename T>
+    void test(std::mt19937_64& rng, size_t iterations)
+    {
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            const unsigned letters = 1 + rng() % 3;
+            std::vector<T> text(rng() % 300), pattern(rng() % 12);
+            std::generate(text.begin(), text.end(), [&] { return static_cast<T>('a' + rng() % letters); });
+            if(rng() % 2 == 0 && pattern.size() <= text.size())
+            {
+                const size_t at = rng() % (text.size() - pattern.size() + 1);
+                std::copy_n(text.begin() + at, pattern.size(), pattern.begin());
+            }
+            else
+                std::generate(pattern.begin(), pattern.end(), [&] { return static_cast<T>('a' + rng() % letters); });
+
+            StreamSearcher<typename std::vector<T>::const_iterator> searcher(pattern.cbegin(), pattern.cend());
+            const auto expected = all_matches(pattern, text);
+            check(feed(rng, searcher, text, pattern.size()) == expected, "matches", pattern.size(), text.size());
+            check(searcher.position() == text.size(), "position", pattern.size(), text.size());
+
+            // A new stream after reset, cut differently
+            searcher.reset();
+            check(searcher.position() == 0 && feed(rng, searcher, text, pattern.size()) == expected, "reset",
+                  pattern.size(), text.size());
+        }
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::random_device{}();
+    std::printf("stream_searcher_test %zu %llu\n", iterations, static_cast<unsigned long long>(seed));
+    std::mt19937_64 rng(seed);
+
+    test<char>(rng, iterations);
+    test<int>(rng, iterations / 4);
+
+    std::printf("%zu failures\n", failures);
+    return failures != 0;
+}
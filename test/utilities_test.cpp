@@ -0,0 +1,174 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+// Checks of the containers of utilities/ on the cases their fixes were about: views with arbitrary strides,
+// moved-from objects, sparse rows filled out of step and copy-on-write buffers. The exit status is 1 on any failure
+
+#include <cstdio>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "utilities.hpp"
+
+
+namespace
+{
+    size_t failures = 0;
+
+    void check(bool ok, const char* what)
+    {
+        if(!ok)
+        {
+            std::printf("FAILED %s\n", what);
+            ++failures;
+        }
+    }
+
+    void test_arrayN()
+    {
+        ut::arrayN<int, 2> a(3, 4);
+        std::iota(a.begin(), a.end(), 0);
+
+        // Transposed view: the end position and the elements of the last column alias other addresses
+        ut::arrayN_view<int, 2> t(a.data(), {4, 3}, {1, 4});
+        std::vector<int> seen(t.begin(), t.end());
+        const std::vector<int> expected{0, 4, 8, 1, 5, 9, 2, 6, 10, 3, 7, 11};
+        check(seen == expected, "arrayN transposed view iteration");
+
+        // Overlapping view, every row starting one element after the previous one
+        ut::arrayN_view<int, 2> o(a.data(), {3, 3}, {1, 1});
+        check(std::distance(o.begin(), o.end()) == 9, "arrayN overlapping view length");
+
+        ut::arrayN<int, 2> b(std::move(a));
+        check(a.empty() && a.dim(0) == 0 && b.size() == 12 && b(2, 3) == 11, "arrayN move");
+    }
+
+    void test_static_array2()
+    {
+        ut::static_array2<int, 2, 3> a;
+        std::iota(a.begin(), a.end(), 0);
+        check(!a.empty() && a(1, 2) == 5 && ut::static_array2<int, 0, 0>::empty(), "static_array2");
+    }
+
+    void test_planar_array2()
+    {
+        ut::array2<std::array<float, 3>> pixels(5, 7);
+        for(size_t i = 0; i < 5; ++i)
+            for(size_t j = 0; j < 7; ++j)
+                pixels(i, j) = {float(i), float(j), float(i * j)};
+
+        ut::planar_array2<float, 3> p(pixels);
+        check(p.plane(2)(4, 6) == 24.f && p.plane<1>()(3, 5) == 5.f, "planar_array2 deinterleave");
+
+        const ut::planar_array2<float, 3> copy(p);
+        const auto back = copy.interleave();
+        check(std::equal(back.begin(), back.end(), pixels.begin()), "planar_array2 copy and interleave");
+
+        ut::planar_array2<float, 3> moved(std::move(p));
+        const ut::planar_array2<float, 3> from_empty(p);
+        check(p.empty() && p.dim(0) == 0 && from_empty.empty() && moved.plane(2)(4, 6) == 24.f,
+              "planar_array2 moved-from");
+        p = std::move(moved);
+        check(moved.empty() && p.plane(0)(4, 0) == 4.f, "planar_array2 move assignment");
+    }
+
+    void test_sparse_array2()
+    {
+        ut::array2<double> dense(6, 5);
+        std::fill(dense.begin(), dense.end(), 0.);
+        dense(0, 1) = 2.;
+        dense(3, 0) = -1.;
+        dense(3, 4) = 0.5;
+        dense(5, 2) = 3.;
+
+        // Rows filled with gaps, the trailing ones left pending
+        ut::sparse_array2<double> s(6, 5);
+        s.push_back(0, 1, 2.);
+        s.push_back(3, 0, -1.);
+        s.push_back(3, 4, 0.5);
+        const auto &cs = s;
+        bool threw = false;
+        try
+        {
+            cs.row_ptr();
+        }
+        catch(const std::logic_error &)
+        {
+            threw = true;
+        }
+        check(threw, "sparse_array2 const row_ptr with pending rows");
+        check(cs(3, 4) == 0.5 && cs(4, 4) == 0. && cs(5, 2) == 0., "sparse_array2 access with pending rows");
+
+        bool rejected = false;
+        try
+        {
+            s.push_back(2, 0, 1.);
+        }
+        catch(const std::invalid_argument &)
+        {
+            rejected = true;
+        }
+        check(rejected, "sparse_array2 push_back on an earlier row");
+
+        s.push_back(5, 2, 3.);
+        const auto to_dense = cs.to_array2();
+        check(std::equal(to_dense.begin(), to_dense.end(), dense.begin()), "sparse_array2 to_array2");
+        check(cs.row_ptr() == std::vector<size_t>{0, 1, 1, 1, 3, 3, 4}, "sparse_array2 row_ptr");
+
+        size_t count = 0;
+        for(const auto &e : cs)
+            count += dense(e.row, e.col) == e.value;
+        check(count == 4, "sparse_array2 iteration");
+
+        ut::array2<double> b(5, 2);
+        std::iota(b.begin(), b.end(), 1.);
+        const auto product = s * b;
+        const ut::sparse_array2<double> from_dense(dense);
+        const auto expected = from_dense * b;
+        check(std::equal(product.begin(), product.end(), expected.begin()) && product(3, 1) == -2. + 0.5 * 10.,
+              "sparse_array2 multiply");
+    }
+
+    void test_shared_arrayN()
+    {
+        ut::shared_array2<int> a(ut::arrayN<int, 2>(3, 4));
+        auto &r = a.mutate();
+        std::fill(r.begin(), r.end(), 0);
+        r(1, 2) = 5;
+
+        // Copies and views taken while the reference is live get their own buffer
+        const ut::shared_array2<int> copy(a);
+        const auto view = a.view();
+        ut::shared_array2<int> assigned;
+        assigned = a;
+        r(1, 2) = 7;
+        check((*copy)(1, 2) == 5 && (*view)(1, 2) == 5 && (*assigned)(1, 2) == 5 && (*a)(1, 2) == 7,
+              "shared_arrayN copies after mutate");
+
+        a.share();
+        ut::shared_array2<int> shared(a);
+        check(shared.use_count() == 2, "shared_arrayN share");
+        shared.mutate()(0, 0) = 1;
+        check((*a)(0, 0) == 0 && (*shared)(0, 0) == 1 && a.unique(), "shared_arrayN copy-on-write");
+
+        ut::shared_array2<int> moved(std::move(a));
+        check(a.empty() && a.dim()[0] == 0 && a.begin() == a.end() && (*moved)(1, 2) == 7, "shared_arrayN moved-from");
+        a.mutate();
+        check(a.empty() && a.unique(), "shared_arrayN mutate on moved-from");
+    }
+}
+
+
+int main()
+{
+    test_arrayN();
+    test_static_array2();
+    test_planar_array2();
+    test_sparse_array2();
+    test_shared_arrayN();
+
+    std::printf("%zu failures\n", failures);
+    return failures != 0;
+}
@@ -2,10 +2,15 @@
 #define UTILITIES_HPP
 
 #include "utilities/array2.hpp"
+#include "utilities/arrayN.hpp"
 #include "utilities/choose.hpp"
 #include "utilities/dct.hpp"
 #include "utilities/misc.hpp"
+#include "utilities/planar_array2.hpp"
 #include "utilities/ptr_iterator.hpp"
 #include "utilities/range.hpp"
+#include "utilities/shared_arrayN.hpp"
+#include "utilities/sparse_array2.hpp"
+#include "utilities/static_array2.hpp"
 
 #endif //UTILITIES_HPP
\ No newline at end of file
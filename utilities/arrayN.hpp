@@ -0,0 +1,600 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+#ifndef UTILITIES_ARRAYN_HPP
+#define UTILITIES_ARRAYN_HPP
+
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <initializer_list>
+#include <type_traits>
+#include "ptr_iterator.hpp"
+
+namespace ut
+{
+    // Expands to U once per element of an index pack, used to declare Rank parameters of the same type
+    template<std::size_t, typename U>
+    using repeat_type = U;
+
+    template<typename T, std::size_t Rank, typename Indices = std::make_index_sequence<Rank>>
+    class arrayN;
+
+    template<typename T, std::size_t Rank, typename Indices = std::make_index_sequence<Rank>>
+    class arrayN_view;
+
+    template<typename T, std::size_t Rank, bool is_const = false>
+    struct arrayN_view_iterator_base;
+
+
+    // Rank-dimensional array stored row-major in a single contiguous allocation
+    template<typename T, std::size_t Rank, std::size_t... I>
+    class arrayN<T, Rank, std::index_sequence<I...>>
+    {
+        static_assert(Rank > 0, "rank must be greater than 0");
+
+        public:
+            // Aliases for types
+            using value_type = T;
+            using pointer = T *;
+            using const_pointer = const T *;
+            using reference = T &;
+            using const_reference = const T &;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+
+            using index_type = std::array<size_type, Rank>;
+            using range_type = std::array<size_type, 2>;
+            using view_type = arrayN_view<T, Rank>;
+
+            using iterator = pointer_iterator_base<T, false>;
+            using const_iterator = pointer_iterator_base<T, true>;
+            using reverse_iterator = std::reverse_iterator<iterator>;
+            using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+            static constexpr size_type rank = Rank;
+
+            // friend class
+            template<typename, std::size_t, typename>
+            friend class arrayN_view;
+
+            // constructors
+            arrayN() noexcept;
+            explicit arrayN(repeat_type<I, size_type>... dim);
+            arrayN(repeat_type<I, size_type>... dim, std::initializer_list<value_type> data);
+            explicit arrayN(index_type dim);
+            arrayN(index_type dim, std::initializer_list<value_type> data);
+            template<typename A, typename = std::enable_if_t<std::rank_v<A> == Rank &&
+                                                             std::is_same_v<std::remove_cv_t<std::remove_all_extents_t<A>>, T>>>
+            explicit arrayN(A &array);
+            explicit arrayN(const view_type &av);
+            arrayN(const arrayN &a);
+            arrayN(arrayN &&a) noexcept;
+            ~arrayN() = default;
+
+            // move & copy assigment
+            arrayN &operator=(const arrayN &a);
+            arrayN &operator=(arrayN &&a) noexcept;
+
+            // accessors
+            reference operator()(repeat_type<I, size_type>... idx)
+            {
+                check(idx...);
+                return data_.get()[offset(idx...)];
+            }
+            const_reference operator()(repeat_type<I, size_type>... idx) const
+            {
+                check(idx...);
+                return data_.get()[offset(idx...)];
+            }
+
+            // Sub-view over the inclusive range [r[0], r[1]] of each axis
+            view_type operator()(repeat_type<I, range_type>... r);
+            const view_type operator()(repeat_type<I, range_type>... r) const;
+
+            // Sub-view of rank Rank-1 made of the elements whose index along Axis is index
+            template<size_type Axis>
+            arrayN_view<T, Rank - 1> slice(size_type index) { return view_type(*this).template slice<Axis>(index); }
+            template<size_type Axis>
+            const arrayN_view<T, Rank - 1> slice(size_type index) const
+            {
+                return view_type(const_cast<arrayN &>(*this)).template slice<Axis>(index);
+            }
+
+            // getters
+            const index_type &dim() const noexcept { return dims_; }
+            template<size_type N>
+            size_type dim() const noexcept { return std::get<N>(dims_); }
+            size_type dim(size_type n) const { return (n < Rank) ? dims_[n] : throw std::out_of_range(""); }
+            size_type size() const noexcept { return n_elems_; }
+            pointer data() noexcept { return data_.get(); }
+            const_pointer data() const noexcept { return data_.get(); }
+            bool empty() const noexcept { return !n_elems_; }
+
+            // modifiers
+            void resize(repeat_type<I, size_type>... dim) { resize(index_type{dim...}); }
+            void resize(index_type dim);
+
+            // iterators
+            iterator begin() noexcept { return iterator(data_.get()); }
+            const_iterator begin() const noexcept { return const_iterator(data_.get()); }
+            iterator end() noexcept { return iterator(data_.get() + n_elems_); }
+            const_iterator end() const noexcept { return const_iterator(data_.get() + n_elems_); }
+            const_iterator cbegin() const noexcept { return const_iterator(data_.get()); }
+            const_iterator cend() const noexcept { return const_iterator(data_.get() + n_elems_); }
+            reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(cend()); }
+            reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(cbegin()); }
+            const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+            const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+            iterator iter(repeat_type<I, size_type>... idx)
+            {
+                check(idx...);
+                return iterator(data_.get() + offset(idx...));
+            }
+            const_iterator iter(repeat_type<I, size_type>... idx) const { return citer(idx...); }
+            const_iterator citer(repeat_type<I, size_type>... idx) const
+            {
+                check(idx...);
+                return const_iterator(data_.get() + offset(idx...));
+            }
+            reverse_iterator riter(repeat_type<I, size_type>... idx) { return reverse_iterator(++iter(idx...)); }
+            const_reverse_iterator riter(repeat_type<I, size_type>... idx) const { return criter(idx...); }
+            const_reverse_iterator criter(repeat_type<I, size_type>... idx) const
+            {
+                return const_reverse_iterator(++citer(idx...));
+            }
+
+            // Row-major strides of an array of dimensions dim, the trip count being known at compile time
+            static index_type strides_of(const index_type &dim) noexcept
+            {
+                index_type strides{};
+                size_type acc = 1;
+                for(size_type k = Rank; k-- > 0;)
+                {
+                    strides[k] = acc;
+                    acc *= dim[k];
+                }
+                return strides;
+            }
+
+        private:
+            void check(repeat_type<I, size_type>... idx) const
+            {
+                if(((idx >= dims_[I]) || ...))
+                    throw std::out_of_range("");
+            }
+
+            size_type offset(repeat_type<I, size_type>... idx) const noexcept
+            {
+                size_type o = 0;
+                ((o = o * dims_[I] + idx), ...);
+                return o;
+            }
+
+            size_type n_elems_;
+            index_type dims_;
+            std::unique_ptr<value_type[]> data_;
+    };
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN<T, Rank, std::index_sequence<I...>>::arrayN() noexcept :
+        n_elems_{0},
+        dims_{},
+        data_{nullptr} {}
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN<T, Rank, std::index_sequence<I...>>::arrayN(repeat_type<I, size_type>... dim) :
+        arrayN(index_type{dim...}) {}
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN<T, Rank, std::index_sequence<I...>>::arrayN(repeat_type<I, size_type>... dim,
+                                                       std::initializer_list<value_type> data) :
+        arrayN(index_type{dim...}, data) {}
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN<T, Rank, std::index_sequence<I...>>::arrayN(index_type dim) :
+        n_elems_{(dim[I] * ... * 1)},
+        dims_{std::move(dim)},
+        data_{new value_type[n_elems_]} {}
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN<T, Rank, std::index_sequence<I...>>::arrayN(index_type dim, std::initializer_list<value_type> data) :
+        arrayN(dim)
+    {
+        std::copy_n(data.begin(), std::min(data.size(), n_elems_), data_.get());
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    template<typename A, typename>
+    arrayN<T, Rank, std::index_sequence<I...>>::arrayN(A &array) :
+        arrayN(index_type{std::extent_v<A, I>...})
+    {
+        std::copy_n(reinterpret_cast<const_pointer>(&array), n_elems_, data_.get());
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN<T, Rank, std::index_sequence<I...>>::arrayN(const view_type &av) :
+        arrayN(av.dims_)
+    {
+        std::copy_n(av.begin(), n_elems_, data_.get());
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN<T, Rank, std::index_sequence<I...>>::arrayN(const arrayN &a) :
+        arrayN(a.dims_)
+    {
+        std::copy_n(a.data_.get(), n_elems_, data_.get());
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN<T, Rank, std::index_sequence<I...>>::arrayN(arrayN &&a) noexcept :
+        n_elems_{std::exchange(a.n_elems_, 0)},
+        dims_{std::exchange(a.dims_, index_type{})},
+        data_{std::move(a.data_)} {}
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN<T, Rank, std::index_sequence<I...>> &arrayN<T, Rank, std::index_sequence<I...>>::operator=(const arrayN &a)
+    {
+        if(this != &a)
+            *this = arrayN(a);
+
+        return *this;
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN<T, Rank, std::index_sequence<I...>> &arrayN<T, Rank, std::index_sequence<I...>>::operator=(arrayN &&a) noexcept
+    {
+        data_ = std::move(a.data_);
+        n_elems_ = std::exchange(a.n_elems_, 0);
+        dims_ = std::exchange(a.dims_, index_type{});
+
+        return *this;
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    typename arrayN<T, Rank, std::index_sequence<I...>>::view_type
+    arrayN<T, Rank, std::index_sequence<I...>>::operator()(repeat_type<I, range_type>... r)
+    {
+        if(((r[0] > r[1] || r[0] >= dims_[I]) || ...))
+            throw std::out_of_range("");
+        return view_type(*this, index_type{r[0]...}, index_type{(std::min(r[1] + 1, dims_[I]) - r[0])...});
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    const typename arrayN<T, Rank, std::index_sequence<I...>>::view_type
+    arrayN<T, Rank, std::index_sequence<I...>>::operator()(repeat_type<I, range_type>... r) const
+    {
+        return const_cast<arrayN &>(*this)(r...);
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    void arrayN<T, Rank, std::index_sequence<I...>>::resize(index_type dim)
+    {
+        arrayN temp(dim);
+        const index_type overlap{std::min(dim[I], dims_[I])...};
+        view_type(temp, index_type{}, overlap) = view_type(*this, index_type{}, overlap);
+
+        *this = std::move(temp);
+    }
+
+
+    // Non-owning window over a Rank-dimensional block of elements, described by its origin, dimensions and strides
+    template<typename T, std::size_t Rank, std::size_t... I>
+    class arrayN_view<T, Rank, std::index_sequence<I...>>
+    {
+        static_assert(Rank > 0, "rank must be greater than 0");
+
+        public:
+            // Aliases
+            using value_type = T;
+            using pointer = T *;
+            using const_pointer = const T *;
+            using reference = T &;
+            using const_reference = const T &;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+
+            using index_type = std::array<size_type, Rank>;
+            using range_type = std::array<size_type, 2>;
+
+            using iterator = arrayN_view_iterator_base<T, Rank, false>;
+            using const_iterator = arrayN_view_iterator_base<T, Rank, true>;
+            using reverse_iterator = std::reverse_iterator<iterator>;
+            using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+            static constexpr size_type rank = Rank;
+
+            // friend class
+            template<typename, std::size_t, typename>
+            friend class arrayN;
+            template<typename, std::size_t, typename>
+            friend class arrayN_view;
+            friend struct arrayN_view_iterator_base<value_type, Rank, false>;
+            friend struct arrayN_view_iterator_base<value_type, Rank, true>;
+
+            arrayN_view(pointer origin, index_type dim, index_type strides) noexcept :
+                origin_{origin}, dims_{dim}, strides_{strides} {}
+            arrayN_view(arrayN<value_type, Rank> &array) noexcept :
+                arrayN_view(array.data(), array.dim(), arrayN<value_type, Rank>::strides_of(array.dim())) {}
+            arrayN_view(arrayN<value_type, Rank> &array, index_type offset) noexcept :
+                arrayN_view(array, offset, array.dim()) {}
+            arrayN_view(arrayN<value_type, Rank> &array, index_type offset, index_type size) noexcept :
+                arrayN_view(array)
+            {
+                origin_ += ((std::min(offset[I], array.dim(I)) * strides_[I]) + ... + 0);
+                ((dims_[I] = offset[I] < array.dim(I) ? std::min(array.dim(I) - offset[I], size[I]) : 0), ...);
+            }
+            arrayN_view(arrayN<value_type, Rank> &array, repeat_type<I, size_type>... offset) noexcept :
+                arrayN_view(array, index_type{offset...}) {}
+            arrayN_view(arrayN<value_type, Rank> &array, repeat_type<I, size_type>... offset,
+                        repeat_type<I, size_type>... size) noexcept :
+                arrayN_view(array, index_type{offset...}, index_type{size...}) {}
+            arrayN_view(const arrayN_view &) = default;
+
+            arrayN_view &operator=(const arrayN_view &lhs);
+            arrayN_view &operator=(const arrayN<value_type, Rank> &lhs);
+
+            // accessors
+            reference operator()(repeat_type<I, size_type>... idx)
+            {
+                check(idx...);
+                return origin_[offset(index_type{idx...})];
+            }
+            const_reference operator()(repeat_type<I, size_type>... idx) const
+            {
+                check(idx...);
+                return origin_[offset(index_type{idx...})];
+            }
+
+            // Sub-view over the inclusive range [r[0], r[1]] of each axis, relative to this view
+            arrayN_view operator()(repeat_type<I, range_type>... r);
+            const arrayN_view operator()(repeat_type<I, range_type>... r) const
+            {
+                return const_cast<arrayN_view &>(*this)(r...);
+            }
+
+            // Sub-view of rank Rank-1 made of the elements whose index along Axis is index
+            template<size_type Axis>
+            arrayN_view<T, Rank - 1> slice(size_type index);
+            template<size_type Axis>
+            const arrayN_view<T, Rank - 1> slice(size_type index) const
+            {
+                return const_cast<arrayN_view &>(*this).template slice<Axis>(index);
+            }
+
+            //getters
+            const index_type &dim() const noexcept { return dims_; }
+
+            template<size_type N>
+            size_type dim() const noexcept { return std::get<N>(dims_); }
+
+            size_type dim(size_type n) const { return (n < Rank) ? dims_[n] : throw std::out_of_range(""); }
+
+            const index_type &strides() const noexcept { return strides_; }
+
+            size_type size() const noexcept { return (dims_[I] * ... * 1); }
+
+            pointer data() noexcept { return origin_; }
+
+            const_pointer data() const noexcept { return origin_; }
+
+            bool empty() const noexcept { return !(dims_[I] && ...); }
+
+            // iterators
+            iterator begin() noexcept { return iterator(this); }
+
+            const_iterator begin() const noexcept { return const_iterator(this); }
+
+            const_iterator cbegin() const noexcept { return const_iterator(this); }
+
+            iterator end() noexcept { return empty() ? begin() : iterator(this, end_index()); }
+
+            const_iterator end() const noexcept { return empty() ? begin() : const_iterator(this, end_index()); }
+
+            const_iterator cend() const noexcept { return end(); }
+
+            reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(cend()); }
+
+            reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+            const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+
+            const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+            iterator iter(repeat_type<I, size_type>... idx)
+            {
+                check(idx...);
+                return iterator(this, index_type{idx...});
+            }
+
+            const_iterator iter(repeat_type<I, size_type>... idx) const { return citer(idx...); }
+
+            const_iterator citer(repeat_type<I, size_type>... idx) const
+            {
+                check(idx...);
+                return const_iterator(this, index_type{idx...});
+            }
+
+            reverse_iterator riter(repeat_type<I, size_type>... idx) { return reverse_iterator(++iter(idx...)); }
+
+            const_reverse_iterator riter(repeat_type<I, size_type>... idx) const { return criter(idx...); }
+
+            const_reverse_iterator criter(repeat_type<I, size_type>... idx) const
+            {
+                return const_reverse_iterator(++citer(idx...));
+            }
+
+        private:
+            void check(repeat_type<I, size_type>... idx) const
+            {
+                if(((idx >= dims_[I]) || ...))
+                    throw std::out_of_range("");
+            }
+
+            size_type offset(const index_type &idx) const noexcept { return ((idx[I] * strides_[I]) + ... + 0); }
+
+            index_type end_index() const noexcept
+            {
+                index_type idx{};
+                idx[0] = dims_[0];
+                return idx;
+            }
+
+            pointer origin_;
+            index_type dims_;
+            index_type strides_;
+    };
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN_view<T, Rank, std::index_sequence<I...>> &
+    arrayN_view<T, Rank, std::index_sequence<I...>>::operator=(const arrayN_view &lhs)
+    {
+        if(dim() != lhs.dim())
+            throw std::invalid_argument("");
+        std::copy(lhs.begin(), lhs.end(), begin());
+
+        return *this;
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN_view<T, Rank, std::index_sequence<I...>> &
+    arrayN_view<T, Rank, std::index_sequence<I...>>::operator=(const arrayN<T, Rank> &lhs)
+    {
+        if(dim() != lhs.dim())
+            throw std::invalid_argument("");
+        std::copy(lhs.begin(), lhs.end(), begin());
+
+        return *this;
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    arrayN_view<T, Rank, std::index_sequence<I...>>
+    arrayN_view<T, Rank, std::index_sequence<I...>>::operator()(repeat_type<I, range_type>... r)
+    {
+        if(((r[0] > r[1] || r[0] >= dims_[I]) || ...))
+            throw std::out_of_range("");
+        return arrayN_view(origin_ + offset(index_type{r[0]...}),
+                           index_type{(std::min(r[1] + 1, dims_[I]) - r[0])...}, strides_);
+    }
+
+    template<typename T, std::size_t Rank, std::size_t... I>
+    template<typename arrayN_view<T, Rank, std::index_sequence<I...>>::size_type Axis>
+    arrayN_view<T, Rank - 1> arrayN_view<T, Rank, std::index_sequence<I...>>::slice(size_type index)
+    {
+        static_assert(Axis < Rank && Rank > 1, "slice axis out of range");
+
+        if(index >= dims_[Axis])
+            throw std::out_of_range("");
+
+        std::array<size_type, Rank - 1> dim{}, strides{};
+        for(size_type k = 0, l = 0; k < Rank; ++k)
+        {
+            if(k == Axis)
+                continue;
+            dim[l] = dims_[k];
+            strides[l++] = strides_[k];
+        }
+        return arrayN_view<T, Rank - 1>(origin_ + index * strides_[Axis], dim, strides);
+    }
+
+
+    template<typename T, std::size_t Rank, bool is_const>
+    struct arrayN_view_iterator_base
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using pointer = typename choose<is_const, const T *, T *>::type;
+        using reference = typename choose<is_const, const T &, T &>::type;
+        using difference_type = std::ptrdiff_t;
+
+        using index_type = std::array<std::size_t, Rank>;
+        using view_pointer = typename choose<is_const, const arrayN_view<value_type, Rank> *,
+                                             arrayN_view<value_type, Rank> *>::type;
+
+        explicit arrayN_view_iterator_base(view_pointer av = nullptr) noexcept :
+            av_{av}, idx_{}, p_{av ? av->origin_ : nullptr} {}
+
+        arrayN_view_iterator_base(view_pointer av, index_type idx) noexcept :
+            av_{av}, idx_{idx}, p_{av->origin_ + av->offset(idx)} {}
+
+        arrayN_view_iterator_base(const arrayN_view_iterator_base<value_type, Rank, false> &it) noexcept :
+            av_{it.av_}, idx_{it.idx_}, p_{it.p_} {}
+
+
+        // operators
+        // The strides of a view are arbitrary (a transposed or overlapping one), so two positions can share an
+        // address and the end position can alias an element: the indices are compared, the address telling views apart
+        bool operator==(const arrayN_view_iterator_base<T, Rank, true> other) const noexcept
+        {
+            return p_ == other.p_ && idx_ == other.idx_;
+        }
+
+        bool operator!=(const arrayN_view_iterator_base<T, Rank, true> other) const noexcept { return !(*this == other); }
+
+        reference operator*() const noexcept { return *p_; }
+
+        pointer operator->() const noexcept { return p_; }
+
+        // Odometer increment: the last axis moves fastest, carrying into the previous ones
+        arrayN_view_iterator_base &operator++() noexcept
+        {
+            for(std::size_t k = Rank; k-- > 0;)
+            {
+                ++idx_[k];
+                p_ += av_->strides_[k];
+                if(idx_[k] < av_->dims_[k] || k == 0)
+                    break;
+                p_ -= idx_[k] * av_->strides_[k];
+                idx_[k] = 0;
+            }
+            return *this;
+        }
+
+        arrayN_view_iterator_base operator++(int) noexcept
+        {
+            auto temp(*this);
+            ++(*this);
+            return temp;
+        }
+
+        arrayN_view_iterator_base &operator--() noexcept
+        {
+            for(std::size_t k = Rank; k-- > 0;)
+            {
+                if(idx_[k] > 0 || k == 0)
+                {
+                    --idx_[k];
+                    p_ -= av_->strides_[k];
+                    break;
+                }
+                idx_[k] = av_->dims_[k] - 1;
+                p_ += idx_[k] * av_->strides_[k];
+            }
+            return *this;
+        }
+
+        arrayN_view_iterator_base operator--(int) noexcept
+        {
+            auto temp(*this);
+            --(*this);
+            return temp;
+        }
+
+
+        view_pointer av_ = nullptr;
+        index_type idx_;
+        pointer p_ = nullptr;
+    };
+};
+
+#endif //UTILITIES_ARRAYN_HPP
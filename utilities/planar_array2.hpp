@@ -0,0 +1,213 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+#ifndef UTILITIES_PLANAR_ARRAY2_HPP
+#define UTILITIES_PLANAR_ARRAY2_HPP
+
+#include <array>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "array2.hpp"
+
+namespace ut
+{
+    // Multi-channel 2D array stored plane by plane (structure of arrays): every channel lives in its own
+    // contiguous plane, each plane starting on an alignment-byte boundary, all planes sharing the same dimensions
+    template<typename T, std::size_t Channels>
+    class planar_array2
+    {
+        static_assert(Channels > 0, "number of channels must be greater than 0");
+        static_assert(std::is_trivial_v<T>, "planes only hold trivial types");
+
+        public:
+            // Aliases for types
+            using value_type = T;
+            using pointer = T *;
+            using const_pointer = const T *;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+
+            using pixel_type = std::array<T, Channels>;
+            using plane_type = array2_view<T>;
+
+            static constexpr size_type channels = Channels;
+            static constexpr size_type alignment = 64;
+
+            // constructors
+            planar_array2() noexcept : pitch_{0}, dims_{0, 0}, data_{nullptr} {}
+            planar_array2(size_type a, size_type b) : planar_array2(std::array<size_type, 2>{a, b}) {}
+            explicit planar_array2(std::array<size_type, 2> dim);
+            explicit planar_array2(const array2_view<pixel_type> &pixels);
+            planar_array2(const planar_array2 &a);
+            planar_array2(planar_array2 &&a) noexcept;
+            ~planar_array2() = default;
+
+            // move & copy assigment
+            planar_array2 &operator=(const planar_array2 &a);
+            planar_array2 &operator=(planar_array2 &&a) noexcept;
+
+            // accessors
+            plane_type plane(size_type c);
+            const plane_type plane(size_type c) const { return const_cast<planar_array2 &>(*this).plane(c); }
+
+            template<size_type C>
+            plane_type plane() noexcept
+            {
+                static_assert(C < Channels, "channel out of range");
+                return plane_type(data(C), dims_, {dims_[1], 1});
+            }
+
+            template<size_type C>
+            const plane_type plane() const noexcept { return const_cast<planar_array2 &>(*this).template plane<C>(); }
+
+            // getters
+            const std::array<size_type, 2> &dim() const noexcept { return dims_; }
+            template<size_type N>
+            size_type dim() const noexcept { return std::get<N>(dims_); }
+            size_type dim(size_type n) const { return (n < 2) ? dims_[n] : throw std::out_of_range(""); }
+            pointer data(size_type c) noexcept { return data_.get() + c * pitch_; }
+            const_pointer data(size_type c) const noexcept { return data_.get() + c * pitch_; }
+            bool empty() const noexcept { return dims_[0] * dims_[1] == 0; }
+
+            // Conversions from and to the interleaved (array of structures) layout, dimensions must match
+            void deinterleave(const array2_view<pixel_type> &pixels);
+            void interleave(array2_view<pixel_type> pixels) const;
+            array2<pixel_type> interleave() const;
+
+        private:
+            struct aligned_delete
+            {
+                void operator()(T *p) const noexcept { ::operator delete[](p, std::align_val_t{alignment}); }
+            };
+
+            // Number of elements of a plane, rounded up so that the next plane stays aligned
+            static size_type pitch_of(std::array<size_type, 2> dim) noexcept
+            {
+                constexpr size_type step = alignment % sizeof(T) == 0 ? alignment / sizeof(T) : alignment;
+                return (dim[0] * dim[1] + step - 1) / step * step;
+            }
+
+            static T *allocate(size_type n)
+            {
+                return static_cast<T *>(::operator new[](n * sizeof(T), std::align_val_t{alignment}));
+            }
+
+            size_type pitch_;
+            std::array<size_type, 2> dims_;
+            std::unique_ptr<T, aligned_delete> data_;
+    };
+
+    template<typename T, std::size_t Channels>
+    planar_array2<T, Channels>::planar_array2(std::array<size_type, 2> dim) :
+        pitch_{pitch_of(dim)},
+        dims_{dim},
+        data_{allocate(pitch_ * Channels)} {}
+
+    template<typename T, std::size_t Channels>
+    planar_array2<T, Channels>::planar_array2(const array2_view<pixel_type> &pixels) :
+        planar_array2(pixels.dim())
+    {
+        deinterleave(pixels);
+    }
+
+    template<typename T, std::size_t Channels>
+    planar_array2<T, Channels>::planar_array2(const planar_array2 &a) :
+        planar_array2(a.dims_)
+    {
+        // The padding at the end of a plane is never written, only the elements are copied
+        for(size_type c = 0; c < Channels; ++c)
+            std::copy_n(a.data(c), dims_[0] * dims_[1], data(c));
+    }
+
+    template<typename T, std::size_t Channels>
+    planar_array2<T, Channels>::planar_array2(planar_array2 &&a) noexcept :
+        pitch_{std::exchange(a.pitch_, 0)},
+        dims_{std::exchange(a.dims_, std::array<size_type, 2>{0, 0})},
+        data_{std::move(a.data_)} {}
+
+    template<typename T, std::size_t Channels>
+    planar_array2<T, Channels> &planar_array2<T, Channels>::operator=(const planar_array2 &a)
+    {
+        if(this != &a)
+            *this = planar_array2(a);
+
+        return *this;
+    }
+
+    template<typename T, std::size_t Channels>
+    planar_array2<T, Channels> &planar_array2<T, Channels>::operator=(planar_array2 &&a) noexcept
+    {
+        data_ = std::move(a.data_);
+        pitch_ = std::exchange(a.pitch_, 0);
+        dims_ = std::exchange(a.dims_, std::array<size_type, 2>{0, 0});
+
+        return *this;
+    }
+
+    template<typename T, std::size_t Channels>
+    typename planar_array2<T, Channels>::plane_type planar_array2<T, Channels>::plane(size_type c)
+    {
+        if(c >= Channels)
+            throw std::out_of_range("");
+        return plane_type(data(c), dims_, {dims_[1], 1});
+    }
+
+    template<typename T, std::size_t Channels>
+    void planar_array2<T, Channels>::deinterleave(const array2_view<pixel_type> &pixels)
+    {
+        if(pixels.dim() != dims_)
+            throw std::invalid_argument("");
+
+        const auto strides = pixels.strides();
+        std::array<pointer, Channels> planes;
+        for(size_type c = 0; c < Channels; ++c)
+            planes[c] = data(c);
+
+        // One pass per row, every channel written in the same inner loop so that the source is read once
+        for(size_type i = 0; i < dims_[0]; ++i)
+        {
+            const pixel_type *row = pixels.data() + i * strides[0];
+            const size_type line = i * dims_[1];
+            for(size_type j = 0; j < dims_[1]; ++j)
+                for(size_type c = 0; c < Channels; ++c)
+                    planes[c][line + j] = row[j * strides[1]][c];
+        }
+    }
+
+    template<typename T, std::size_t Channels>
+    void planar_array2<T, Channels>::interleave(array2_view<pixel_type> pixels) const
+    {
+        if(pixels.dim() != dims_)
+            throw std::invalid_argument("");
+
+        const auto strides = pixels.strides();
+        std::array<const_pointer, Channels> planes;
+        for(size_type c = 0; c < Channels; ++c)
+            planes[c] = data(c);
+
+        for(size_type i = 0; i < dims_[0]; ++i)
+        {
+            pixel_type *row = pixels.data() + i * strides[0];
+            const size_type line = i * dims_[1];
+            for(size_type j = 0; j < dims_[1]; ++j)
+                for(size_type c = 0; c < Channels; ++c)
+                    row[j * strides[1]][c] = planes[c][line + j];
+        }
+    }
+
+    template<typename T, std::size_t Channels>
+    array2<typename planar_array2<T, Channels>::pixel_type> planar_array2<T, Channels>::interleave() const
+    {
+        array2<pixel_type> pixels(dims_);
+        interleave(pixels);
+
+        return pixels;
+    }
+};
+
+#endif //UTILITIES_PLANAR_ARRAY2_HPP
@@ -0,0 +1,177 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+#ifndef UTILITIES_SHARED_ARRAYN_HPP
+#define UTILITIES_SHARED_ARRAYN_HPP
+
+#include <memory>
+#include <atomic>
+#include <utility>
+#include "arrayN.hpp"
+
+namespace ut
+{
+    template<typename T, std::size_t Rank>
+    class shared_arrayN_view;
+
+    // arrayN whose buffer is reference-counted and shared between copies: copying only bumps the count,
+    // the buffer being duplicated (copy-on-write) the first time a copy asks for write access while shared.
+    // Once mutate() handed out a reference, the copies and views get their own buffer until share() is called
+    template<typename T, std::size_t Rank>
+    class shared_arrayN
+    {
+        public:
+            // Aliases for types
+            using array_type = arrayN<T, Rank>;
+            using value_type = T;
+            using const_pointer = const T *;
+            using const_reference = const T &;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+
+            using index_type = typename array_type::index_type;
+            using view_type = shared_arrayN_view<T, Rank>;
+
+            using const_iterator = typename array_type::const_iterator;
+            using const_reverse_iterator = typename array_type::const_reverse_iterator;
+
+            // friend class
+            friend class shared_arrayN_view<T, Rank>;
+
+            // constructors
+            shared_arrayN() : array_{std::make_shared<array_type>()} {}
+            explicit shared_arrayN(index_type dim) : array_{std::make_shared<array_type>(dim)} {}
+            explicit shared_arrayN(array_type a) : array_{std::make_shared<array_type>(std::move(a))} {}
+            explicit shared_arrayN(const arrayN_view<T, Rank> &av) : array_{std::make_shared<array_type>(av)} {}
+            shared_arrayN(const shared_arrayN &a) :
+                array_{a.unshareable_ ? std::make_shared<array_type>(*a.array_) : a.array_} {}
+            // The moved-from object is left on an empty buffer, not on a null one
+            shared_arrayN(shared_arrayN &&a) noexcept :
+                array_{std::exchange(a.array_, empty_buffer())},
+                unshareable_{std::exchange(a.unshareable_, false)} {}
+            ~shared_arrayN() = default;
+
+            // move & copy assigment
+            shared_arrayN &operator=(const shared_arrayN &a);
+            shared_arrayN &operator=(shared_arrayN &&a) noexcept;
+
+            // Read access, never copies
+            const array_type &get() const noexcept { return *array_; }
+            const array_type &operator*() const noexcept { return *array_; }
+            const array_type *operator->() const noexcept { return array_.get(); }
+
+            // Write access, duplicates the buffer first if another shared_arrayN or a view still refers to it.
+            // The buffer is then no longer shared: the later copies and views duplicate it, so that writing through
+            // the reference (or any pointer or iterator taken from it) never changes them
+            array_type &mutate();
+            // Declares the references returned by mutate() dead, the copies and views share the buffer again
+            void share() noexcept { unshareable_ = false; }
+
+            // View holding a reference on the current buffer, it stays valid whatever happens to this object
+            view_type view() const { return view_type(*this); }
+
+            // getters
+            const index_type &dim() const noexcept { return array_->dim(); }
+            const_pointer data() const noexcept { return array_->data(); }
+            bool empty() const noexcept { return array_->empty(); }
+            bool unique() const noexcept { return array_.use_count() == 1; }
+            long use_count() const noexcept { return array_.use_count(); }
+
+            // iterators
+            const_iterator begin() const noexcept { return array_->cbegin(); }
+            const_iterator end() const noexcept { return array_->cend(); }
+            const_iterator cbegin() const noexcept { return array_->cbegin(); }
+            const_iterator cend() const noexcept { return array_->cend(); }
+            const_reverse_iterator rbegin() const noexcept { return array_->crbegin(); }
+            const_reverse_iterator rend() const noexcept { return array_->crend(); }
+
+        private:
+            // Shared by all the moved-from objects, so that a move never allocates. mutate() duplicates it like any
+            // shared buffer
+            static const std::shared_ptr<array_type> &empty_buffer() noexcept
+            {
+                static const std::shared_ptr<array_type> empty = std::make_shared<array_type>();
+                return empty;
+            }
+
+            std::shared_ptr<array_type> array_;
+            // Set by mutate() while its reference may still be written through
+            bool unshareable_ = false;
+    };
+
+    template<typename T, std::size_t Rank>
+    shared_arrayN<T, Rank> &shared_arrayN<T, Rank>::operator=(const shared_arrayN &a)
+    {
+        if(this != &a)
+            *this = shared_arrayN(a);
+
+        return *this;
+    }
+
+    template<typename T, std::size_t Rank>
+    shared_arrayN<T, Rank> &shared_arrayN<T, Rank>::operator=(shared_arrayN &&a) noexcept
+    {
+        array_ = std::exchange(a.array_, empty_buffer());
+        unshareable_ = std::exchange(a.unshareable_, false);
+
+        return *this;
+    }
+
+    template<typename T, std::size_t Rank>
+    typename shared_arrayN<T, Rank>::array_type &shared_arrayN<T, Rank>::mutate()
+    {
+        if(array_.use_count() != 1)
+            array_ = std::make_shared<array_type>(*array_);
+        else
+            // The last other owner may have released the buffer on another thread, its reads must be done
+            std::atomic_thread_fence(std::memory_order_acquire);
+        unshareable_ = true;
+
+        return *array_;
+    }
+
+
+    // Read-only arrayN_view that shares the ownership of the buffer it looks at
+    template<typename T, std::size_t Rank>
+    class shared_arrayN_view
+    {
+        public:
+            using array_type = arrayN<T, Rank>;
+            using view_type = arrayN_view<const T, Rank>;
+            using index_type = typename array_type::index_type;
+
+            // Copies the buffer if a reference returned by mutate() may still write into it
+            explicit shared_arrayN_view(const shared_arrayN<T, Rank> &a) :
+                owner_{a.unshareable_ ? std::make_shared<const array_type>(*a.array_) : a.array_},
+                origin_{owner_->data()},
+                dims_{owner_->dim()},
+                strides_{array_type::strides_of(owner_->dim())} {}
+
+            // Narrows a shared view to one of its sub-views, v must look into the same buffer
+            shared_arrayN_view(const shared_arrayN_view &parent, const view_type &v) noexcept :
+                owner_{parent.owner_},
+                origin_{v.data()},
+                dims_{v.dim()},
+                strides_{v.strides()} {}
+
+            // The view is rebuilt on each call since assigning an arrayN_view copies the elements, not the window
+            view_type get() const noexcept { return view_type(origin_, dims_, strides_); }
+            view_type operator*() const noexcept { return get(); }
+
+        private:
+            std::shared_ptr<const array_type> owner_;
+            const T *origin_;
+            index_type dims_;
+            index_type strides_;
+    };
+
+
+    template<typename T>
+    using shared_array2 = shared_arrayN<T, 2>;
+
+    template<typename T>
+    using shared_array2_view = shared_arrayN_view<T, 2>;
+};
+
+#endif //UTILITIES_SHARED_ARRAYN_HPP
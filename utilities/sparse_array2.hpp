@@ -0,0 +1,293 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+#ifndef UTILITIES_SPARSE_ARRAY2_HPP
+#define UTILITIES_SPARSE_ARRAY2_HPP
+
+#include <array>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "array2.hpp"
+
+namespace ut
+{
+    // 2D array in compressed sparse row (CSR) format: only the elements whose magnitude exceed a threshold are
+    // stored, row by row, with their column index
+    template<typename T>
+    class sparse_array2
+    {
+        public:
+            // Aliases for types
+            using value_type = T;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+
+            // Element seen while iterating over the nonzeros
+            struct entry
+            {
+                size_type row;
+                size_type col;
+                const value_type &value;
+            };
+
+            struct const_iterator;
+
+            // constructors
+            sparse_array2() noexcept : dims_{0, 0}, row_ptr_(1, 0), filled_{0} {}
+            sparse_array2(size_type a, size_type b) : dims_{a, b}, row_ptr_(a + 1, 0), filled_{a} {}
+            explicit sparse_array2(const array2_view<value_type> &dense, const value_type &threshold = value_type{});
+            explicit sparse_array2(const array2<value_type> &dense, const value_type &threshold = value_type{}) :
+                sparse_array2(array2_view<value_type>(const_cast<array2<value_type> &>(dense)), threshold) {}
+
+            // accessors
+            // Value at (i, j), zero when the element is not stored
+            value_type operator()(size_type i, size_type j) const;
+
+            // getters
+            const std::array<size_type, 2> &dim() const noexcept { return dims_; }
+            template<size_type N>
+            size_type dim() const noexcept { return std::get<N>(dims_); }
+            size_type dim(size_type n) const { return (n < 2) ? dims_[n] : throw std::out_of_range(""); }
+            size_type nonzeros() const noexcept { return values_.size(); }
+            bool empty() const noexcept { return values_.empty(); }
+
+            // Raw CSR arrays: the nonzeros of row i are at [row_ptr()[i], row_ptr()[i+1]) in col_idx() and values().
+            // The rows after the last one pushed back are only completed by finalize(), which the non-const row_ptr()
+            // calls: the const one never writes and throws std::logic_error if they are still pending
+            const std::vector<size_type> &row_ptr()
+            {
+                finalize();
+                return row_ptr_;
+            }
+            const std::vector<size_type> &row_ptr() const
+            {
+                return filled_ == dims_[0] ? row_ptr_ : throw std::logic_error("");
+            }
+            const std::vector<size_type> &col_idx() const noexcept { return col_idx_; }
+            const std::vector<value_type> &values() const noexcept { return values_; }
+
+            // modifiers
+            // Appends a nonzero, rows must be filled in increasing order and columns in increasing order within a row.
+            // Amortized constant time, the rows skipped being completed when a later one starts
+            void push_back(size_type i, size_type j, value_type value);
+            // Completes the rows after the last one pushed back, in time linear in their number
+            void finalize() noexcept
+            {
+                std::fill(row_ptr_.begin() + filled_ + 1, row_ptr_.end(), values_.size());
+                filled_ = dims_[0];
+            }
+
+            // conversions
+            array2<value_type> to_array2() const;
+
+            // operations
+            array2<value_type> multiply(const array2_view<value_type> &b) const;
+            array2<value_type> multiply(const array2<value_type> &b) const
+            {
+                return multiply(array2_view<value_type>(const_cast<array2<value_type> &>(b)));
+            }
+
+            // iterators over the nonzeros, in row-major order
+            const_iterator begin() const noexcept { return const_iterator(this, 0, 0); }
+            const_iterator end() const noexcept { return const_iterator(this, dims_[0], values_.size()); }
+            const_iterator cbegin() const noexcept { return begin(); }
+            const_iterator cend() const noexcept { return end(); }
+
+        private:
+            static value_type magnitude(const value_type &x)
+            {
+                if constexpr(std::is_signed_v<value_type>)
+                    return x < value_type{} ? -x : x;
+                else
+                    return x;
+            }
+
+            // row_ptr_[k] as if it were up to date
+            size_type offset(size_type k) const noexcept { return k <= filled_ ? row_ptr_[k] : values_.size(); }
+
+            std::array<size_type, 2> dims_;
+            std::vector<size_type> row_ptr_;
+            std::vector<size_type> col_idx_;
+            std::vector<value_type> values_;
+            // row_ptr_[0..filled_] are up to date, the rows after filled_ - 1 have no nonzero
+            size_type filled_;
+    };
+
+    template<typename T>
+    struct sparse_array2<T>::const_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = entry;
+        using reference = entry;
+        using difference_type = std::ptrdiff_t;
+
+        struct pointer
+        {
+            entry e;
+            const entry *operator->() const noexcept { return &e; }
+        };
+
+        const_iterator() = default;
+
+        const_iterator(const sparse_array2 *sa, size_type row, size_type k) noexcept : sa_{sa}, row_{row}, k_{k}
+        {
+            skip_empty_rows();
+        }
+
+        // operators
+        bool operator==(const const_iterator &other) const noexcept { return k_ == other.k_; }
+
+        bool operator!=(const const_iterator &other) const noexcept { return k_ != other.k_; }
+
+        reference operator*() const noexcept { return entry{row_, sa_->col_idx_[k_], sa_->values_[k_]}; }
+
+        pointer operator->() const noexcept { return pointer{**this}; }
+
+        const_iterator &operator++() noexcept
+        {
+            ++k_;
+            skip_empty_rows();
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto temp(*this);
+            ++(*this);
+            return temp;
+        }
+
+        void skip_empty_rows() noexcept
+        {
+            while(row_ < sa_->dims_[0] && k_ >= sa_->offset(row_ + 1))
+                ++row_;
+        }
+
+
+        const sparse_array2 *sa_ = nullptr;
+        size_type row_ = 0;
+        size_type k_ = 0;
+    };
+
+    template<typename T>
+    sparse_array2<T>::sparse_array2(const array2_view<value_type> &dense, const value_type &threshold) :
+        sparse_array2(dense.dim(0), dense.dim(1))
+    {
+        const auto strides = dense.strides();
+
+        // First pass counts the nonzeros so that the storage is allocated once
+        size_type count = 0;
+        for(size_type i = 0; i < dims_[0]; ++i)
+        {
+            const value_type *row = dense.data() + i * strides[0];
+            for(size_type j = 0; j < dims_[1]; ++j)
+                count += magnitude(row[j * strides[1]]) > threshold;
+        }
+        col_idx_.reserve(count);
+        values_.reserve(count);
+
+        for(size_type i = 0; i < dims_[0]; ++i)
+        {
+            const value_type *row = dense.data() + i * strides[0];
+            for(size_type j = 0; j < dims_[1]; ++j)
+            {
+                if(magnitude(row[j * strides[1]]) > threshold)
+                {
+                    col_idx_.push_back(j);
+                    values_.push_back(row[j * strides[1]]);
+                }
+            }
+            row_ptr_[i + 1] = values_.size();
+        }
+    }
+
+    template<typename T>
+    typename sparse_array2<T>::value_type sparse_array2<T>::operator()(size_type i, size_type j) const
+    {
+        if(i >= dims_[0] || j >= dims_[1])
+            throw std::out_of_range("");
+
+        const auto first = col_idx_.begin() + offset(i);
+        const auto last = col_idx_.begin() + offset(i + 1);
+        const auto pos = std::lower_bound(first, last, j);
+        return (pos != last && *pos == j) ? values_[pos - col_idx_.begin()] : value_type{};
+    }
+
+    template<typename T>
+    void sparse_array2<T>::push_back(size_type i, size_type j, value_type value)
+    {
+        if(i >= dims_[0] || j >= dims_[1])
+            throw std::out_of_range("");
+        if(offset(i + 1) != values_.size() || (offset(i) != values_.size() && col_idx_.back() >= j))
+            throw std::invalid_argument("");
+
+        // The rows from the last one filled up to i start at the current end, the later ones are left as they are
+        for(size_type k = filled_ + 1; k <= i; ++k)
+            row_ptr_[k] = values_.size();
+
+        col_idx_.push_back(j);
+        values_.push_back(std::move(value));
+        row_ptr_[i + 1] = values_.size();
+        filled_ = i + 1;
+    }
+
+    template<typename T>
+    array2<typename sparse_array2<T>::value_type> sparse_array2<T>::to_array2() const
+    {
+        array2<value_type> dense(dims_);
+        std::fill(dense.begin(), dense.end(), value_type{});
+
+        value_type *data = dense.data();
+        for(size_type i = 0; i < dims_[0]; ++i)
+            for(size_type k = offset(i); k < offset(i + 1); ++k)
+                data[i * dims_[1] + col_idx_[k]] = values_[k];
+
+        return dense;
+    }
+
+    template<typename T>
+    array2<typename sparse_array2<T>::value_type> sparse_array2<T>::multiply(const array2_view<value_type> &b) const
+    {
+        if(dims_[1] != b.dim(0))
+            throw std::invalid_argument("");
+
+        const size_type n = b.dim(1);
+        const auto strides = b.strides();
+
+        array2<value_type> c(dims_[0], n);
+        std::fill(c.begin(), c.end(), value_type{});
+
+        // Every nonzero a(i, k) scales row k of b into row i of c, so only the stored elements are visited
+        for(size_type i = 0; i < dims_[0]; ++i)
+        {
+            value_type *c_row = c.data() + i * n;
+            for(size_type k = offset(i), last = offset(i + 1); k < last; ++k)
+            {
+                const value_type a = values_[k];
+                const value_type *b_row = b.data() + col_idx_[k] * strides[0];
+                for(size_type j = 0; j < n; ++j)
+                    c_row[j] += a * b_row[j * strides[1]];
+            }
+        }
+
+        return c;
+    }
+
+    template<typename T>
+    array2<T> operator*(const sparse_array2<T> &a, const array2_view<T> &b)
+    {
+        return a.multiply(b);
+    }
+
+    template<typename T>
+    array2<T> operator*(const sparse_array2<T> &a, const array2<T> &b)
+    {
+        return a.multiply(b);
+    }
+};
+
+#endif //UTILITIES_SPARSE_ARRAY2_HPP
@@ -0,0 +1,114 @@
+//
+// Created by thomas on 19/10/26.
+//
+
+#ifndef UTILITIES_STATIC_ARRAY2_HPP
+#define UTILITIES_STATIC_ARRAY2_HPP
+
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <initializer_list>
+#include "array2.hpp"
+
+namespace ut
+{
+    // 2D array whose dimensions are known at compile time, stored inline (no allocation)
+    template<typename T, std::size_t Rows, std::size_t Cols>
+    class static_array2
+    {
+        public:
+            // Aliases for types
+            using value_type = T;
+            using pointer = T *;
+            using const_pointer = const T *;
+            using reference = T &;
+            using const_reference = const T &;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+
+            using range_type = std::array<size_type, 2>;
+            using view_type = array2_view<T>;
+
+            using iterator = pointer_iterator_base<T, false>;
+            using const_iterator = pointer_iterator_base<T, true>;
+            using reverse_iterator = std::reverse_iterator<iterator>;
+            using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+            // constructors
+            constexpr static_array2() noexcept = default;
+            constexpr static_array2(std::initializer_list<value_type> data)
+            {
+                auto it = data.begin();
+                for(size_type k = 0; k < std::min(data.size(), Rows * Cols); ++k)
+                    data_[k] = *it++;
+            }
+            explicit static_array2(const view_type &av)
+            {
+                if(av.dim() != dim())
+                    throw std::invalid_argument("");
+                std::copy(av.begin(), av.end(), data_);
+            }
+            explicit static_array2(const array2<value_type> &a) :
+                static_array2(view_type(const_cast<array2<value_type> &>(a))) {}
+
+            // accessors
+            constexpr reference operator()(size_type i, size_type j)
+            {
+                return (i < Rows && j < Cols) ? data_[i * Cols + j] : throw std::out_of_range("");
+            }
+            constexpr const_reference operator()(size_type i, size_type j) const
+            {
+                return (i < Rows && j < Cols) ? data_[i * Cols + j] : throw std::out_of_range("");
+            }
+
+            view_type operator()(range_type i, range_type j) { return view()(i, j); }
+            const view_type operator()(range_type i, range_type j) const { return view()(i, j); }
+
+            // Whole array seen as an array2_view, so that it can be passed where a view is expected
+            view_type view() noexcept { return view_type(data_, dim(), {Cols, 1}); }
+            const view_type view() const noexcept { return const_cast<static_array2 &>(*this).view(); }
+            operator view_type() noexcept { return view(); }
+            operator const view_type() const noexcept { return view(); }
+
+            // getters
+            static constexpr std::array<size_type, 2> dim() noexcept { return {Rows, Cols}; }
+            template<size_type N>
+            static constexpr size_type dim() noexcept { return std::get<N>(std::array<size_type, 2>{Rows, Cols}); }
+            static constexpr size_type dim(size_type n) { return (n < 2) ? dim()[n] : throw std::out_of_range(""); }
+            static constexpr size_type size() noexcept { return Rows * Cols; }
+            constexpr pointer data() noexcept { return data_; }
+            constexpr const_pointer data() const noexcept { return data_; }
+            static constexpr bool empty() noexcept { return Rows * Cols == 0; }
+
+            // iterators
+            iterator begin() noexcept { return iterator(data_); }
+            const_iterator begin() const noexcept { return const_iterator(data_); }
+            iterator end() noexcept { return iterator(data_ + Rows * Cols); }
+            const_iterator end() const noexcept { return const_iterator(data_ + Rows * Cols); }
+            const_iterator cbegin() const noexcept { return const_iterator(data_); }
+            const_iterator cend() const noexcept { return const_iterator(data_ + Rows * Cols); }
+            reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(cend()); }
+            reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(cbegin()); }
+            const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+            const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+            iterator iter(size_type i, size_type j) { return iterator(&(*this)(i, j)); }
+            const_iterator iter(size_type i, size_type j) const { return const_iterator(&(*this)(i, j)); }
+            const_iterator citer(size_type i, size_type j) const { return const_iterator(&(*this)(i, j)); }
+            reverse_iterator riter(size_type i, size_type j) { return reverse_iterator(++iter(i, j)); }
+            const_reverse_iterator riter(size_type i, size_type j) const { return criter(i, j); }
+            const_reverse_iterator criter(size_type i, size_type j) const
+            {
+                return const_reverse_iterator(++citer(i, j));
+            }
+
+        private:
+            // One extra element keeps the 0x0 case a valid C array
+            value_type data_[Rows * Cols + (Rows * Cols == 0)] = {};
+    };
+};
+
+#endif //UTILITIES_STATIC_ARRAY2_HPP